@@ -8,6 +8,7 @@
 
 #include <rpc/rpc.h>
 
+#include <pthread.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -19,29 +20,123 @@ struct number {
 };
 typedef struct number number;
 
+typedef struct {
+	u_int numberList_len;
+	int *numberList_val;
+} numberList;
+
+typedef struct {
+	u_int resultList_len;
+	quad_t *resultList_val;
+} resultList;
+
+typedef char *digitString;
+#define MAX_MOD_N 100000000
+#define MOD_OUT_OF_RANGE 0xffffffffffffffff
+
+struct modNumber {
+	quad_t x;
+	u_quad_t p;
+};
+typedef struct modNumber modNumber;
+
 #define SUM_PROG 0x12345678
 #define SUM_VERS 1
 
 #if defined(__STDC__) || defined(__cplusplus)
 #define sumFactorial 1
-extern  long * sumfactorial_1(number *, CLIENT *);
-extern  long * sumfactorial_1_svc(number *, struct svc_req *);
+extern  enum clnt_stat sumfactorial_1(number *, long *, CLIENT *);
+extern  bool_t sumfactorial_1_svc(number *, long *, struct svc_req *);
 extern int sum_prog_1_freeresult (SVCXPRT *, xdrproc_t, caddr_t);
 
 #else /* K&R C */
 #define sumFactorial 1
-extern  long * sumfactorial_1();
-extern  long * sumfactorial_1_svc();
+extern  enum clnt_stat sumfactorial_1();
+extern  bool_t sumfactorial_1_svc();
 extern int sum_prog_1_freeresult ();
 #endif /* K&R C */
+#define SUM_BATCH_VERS 2
+
+#if defined(__STDC__) || defined(__cplusplus)
+extern  enum clnt_stat sumfactorial_2(number *, long *, CLIENT *);
+extern  bool_t sumfactorial_2_svc(number *, long *, struct svc_req *);
+#define sumFactorialBatch 2
+extern  enum clnt_stat sumfactorialbatch_2(numberList *, resultList *, CLIENT *);
+extern  bool_t sumfactorialbatch_2_svc(numberList *, resultList *, struct svc_req *);
+extern int sum_prog_2_freeresult (SVCXPRT *, xdrproc_t, caddr_t);
+
+#else /* K&R C */
+extern  enum clnt_stat sumfactorial_2();
+extern  bool_t sumfactorial_2_svc();
+#define sumFactorialBatch 2
+extern  enum clnt_stat sumfactorialbatch_2();
+extern  bool_t sumfactorialbatch_2_svc();
+extern int sum_prog_2_freeresult ();
+#endif /* K&R C */
+#define SUM_EXACT_VERS 3
+
+#if defined(__STDC__) || defined(__cplusplus)
+extern  enum clnt_stat sumfactorial_3(number *, long *, CLIENT *);
+extern  bool_t sumfactorial_3_svc(number *, long *, struct svc_req *);
+extern  enum clnt_stat sumfactorialbatch_3(numberList *, resultList *, CLIENT *);
+extern  bool_t sumfactorialbatch_3_svc(numberList *, resultList *, struct svc_req *);
+#define sumFactorialExact 3
+extern  enum clnt_stat sumfactorialexact_3(number *, digitString *, CLIENT *);
+extern  bool_t sumfactorialexact_3_svc(number *, digitString *, struct svc_req *);
+extern int sum_prog_3_freeresult (SVCXPRT *, xdrproc_t, caddr_t);
+
+#else /* K&R C */
+extern  enum clnt_stat sumfactorial_3();
+extern  bool_t sumfactorial_3_svc();
+extern  enum clnt_stat sumfactorialbatch_3();
+extern  bool_t sumfactorialbatch_3_svc();
+#define sumFactorialExact 3
+extern  enum clnt_stat sumfactorialexact_3();
+extern  bool_t sumfactorialexact_3_svc();
+extern int sum_prog_3_freeresult ();
+#endif /* K&R C */
+#define SUM_MOD_VERS 4
+
+#if defined(__STDC__) || defined(__cplusplus)
+extern  enum clnt_stat sumfactorial_4(number *, long *, CLIENT *);
+extern  bool_t sumfactorial_4_svc(number *, long *, struct svc_req *);
+extern  enum clnt_stat sumfactorialbatch_4(numberList *, resultList *, CLIENT *);
+extern  bool_t sumfactorialbatch_4_svc(numberList *, resultList *, struct svc_req *);
+extern  enum clnt_stat sumfactorialexact_4(number *, digitString *, CLIENT *);
+extern  bool_t sumfactorialexact_4_svc(number *, digitString *, struct svc_req *);
+#define sumFactorialMod 4
+extern  enum clnt_stat sumfactorialmod_4(modNumber *, u_quad_t *, CLIENT *);
+extern  bool_t sumfactorialmod_4_svc(modNumber *, u_quad_t *, struct svc_req *);
+extern int sum_prog_4_freeresult (SVCXPRT *, xdrproc_t, caddr_t);
+
+#else /* K&R C */
+extern  enum clnt_stat sumfactorial_4();
+extern  bool_t sumfactorial_4_svc();
+extern  enum clnt_stat sumfactorialbatch_4();
+extern  bool_t sumfactorialbatch_4_svc();
+extern  enum clnt_stat sumfactorialexact_4();
+extern  bool_t sumfactorialexact_4_svc();
+#define sumFactorialMod 4
+extern  enum clnt_stat sumfactorialmod_4();
+extern  bool_t sumfactorialmod_4_svc();
+extern int sum_prog_4_freeresult ();
+#endif /* K&R C */
 
 /* the xdr functions */
 
 #if defined(__STDC__) || defined(__cplusplus)
 extern  bool_t xdr_number (XDR *, number*);
+extern  bool_t xdr_numberList (XDR *, numberList*);
+extern  bool_t xdr_resultList (XDR *, resultList*);
+extern  bool_t xdr_digitString (XDR *, digitString*);
+extern  bool_t xdr_modNumber (XDR *, modNumber*);
 
 #else /* K&R C */
 extern bool_t xdr_number ();
+extern bool_t xdr_numberList ();
+extern bool_t xdr_resultList ();
+extern bool_t xdr_digitString ();
+extern bool_t xdr_modNumber ();
 
 #endif /* K&R C */
 
@@ -2,8 +2,37 @@ struct number{
     int x;
 };
 
+typedef int numberList<>;
+typedef hyper resultList<>;
+typedef string digitString<>;
+
+/* sumFactorialMod takes up to min(N, p) steps, so it answers N < 0 or
+   N > MAX_MOD_N with MOD_OUT_OF_RANGE, a value no sum modulo p can take */
+const MAX_MOD_N = 100000000;
+const MOD_OUT_OF_RANGE = 0xffffffffffffffff;
+
+struct modNumber{
+    hyper x;
+    unsigned hyper p;
+};
+
 program SUM_PROG{
     version SUM_VERS{
         long sumFactorial(number)=1;
     }=1;
+    version SUM_BATCH_VERS{
+        long sumFactorial(number)=1;
+        resultList sumFactorialBatch(numberList)=2;
+    }=2;
+    version SUM_EXACT_VERS{
+        long sumFactorial(number)=1;
+        resultList sumFactorialBatch(numberList)=2;
+        digitString sumFactorialExact(number)=3;
+    }=3;
+    version SUM_MOD_VERS{
+        long sumFactorial(number)=1;
+        resultList sumFactorialBatch(numberList)=2;
+        digitString sumFactorialExact(number)=3;
+        unsigned hyper sumFactorialMod(modNumber)=4;
+    }=4;
 }=0x12345678;
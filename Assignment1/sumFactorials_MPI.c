@@ -1,17 +1,47 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include <mpi.h>
+#include "sumFactorials_bignum.h"
+
+//Largest N whose sum of factorials fits in 64 bits
+#define MAX_EXACT_N 20
+
+//Function Declarations
+void distributedSumFactorials(int myrank, int numProcessors, long N);
+void exactSumFactorials(int myrank, int numProcessors, long N, int numThreads);
+void sendBignum(const bignum *x, int dest);
+void recvBignum(bignum *x, int source);
+
 int main(int argc, char* argv[]){
 
     int myrank;
     int numProcessors;
     int N;
-    int total;
+    long total;
     //Intialise MPI and store rank and numProcessors
     MPI_Init(&argc, &argv);
     MPI_Comm_rank(MPI_COMM_WORLD, &myrank);
     MPI_Comm_size(MPI_COMM_WORLD, &numProcessors);
     MPI_Status status;
+
+    //Distributed mode: every rank computes a slice of 1..N
+    //usage: mpirun -np P sumFactorials_MPI -d N
+    if (argc == 3 && strcmp(argv[1], "-d") == 0){
+        distributedSumFactorials(myrank, numProcessors, atol(argv[2]));
+        MPI_Finalize();
+        return 0;
+    }
+
+    //Exact mode: every digit of the sum, using THREADS threads per rank (default all cores)
+    //usage: mpirun -np P sumFactorials_MPI -e N [THREADS]
+    if (argc >= 3 && strcmp(argv[1], "-e") == 0){
+        int numThreads = (argc > 3) ? atoi(argv[3]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+        exactSumFactorials(myrank, numProcessors, atol(argv[2]), numThreads < 1 ? 1 : numThreads);
+        MPI_Finalize();
+        return 0;
+    }
     //Root process prompts user for N
     if (myrank == 0){
         printf("Processor Rank %d: Enter a value for N: \n", myrank);
@@ -42,17 +72,143 @@ int main(int argc, char* argv[]){
             total+=factorial;
         }
         //Send result back to root process
-        MPI_Send(&total, 1, MPI_INT, 0, 0, MPI_COMM_WORLD);
+        MPI_Send(&total, 1, MPI_LONG, 0, 0, MPI_COMM_WORLD);
      }
      
     //Root process receives total of computation from Process 1
     if (myrank == 0){
 
-        MPI_Recv(&total, 1, MPI_INT, 1, 0, MPI_COMM_WORLD, &status);
-        printf("Processor Rank %d: Result received from process 1 is: %d \n",myrank,total);
+        MPI_Recv(&total, 1, MPI_LONG, 1, 0, MPI_COMM_WORLD, &status);
+        printf("Processor Rank %d: Result received from process 1 is: %ld \n",myrank,total);
      }
     
     //Exit 
     MPI_Finalize();
     return 0;
 }
+
+void distributedSumFactorials(int myrank, int numProcessors, long N){
+    //Split 1..N into contiguous slices, giving the remainder to the first ranks
+    long npp = N / numProcessors; //npp = numbers per process
+    long nppr = N % numProcessors; //nppr = num per process remainder
+    long sp = myrank * npp + (myrank < nppr ? myrank : nppr) + 1; // Start point
+    long ep = sp + npp + (myrank < nppr ? 1 : 0); // End point (exclusive)
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double start = MPI_Wtime();
+
+    //Unsigned 64-bit arithmetic wraps, so every result is exact modulo 2^64
+    //localSum = sum of k!/(sp-1)! and localProduct = sp*(sp+1)*...*(ep-1)
+    unsigned long long localProduct = 1;
+    unsigned long long localSum = 0;
+    for (long k = sp; k < ep; k++){
+        localProduct *= (unsigned long long)k;
+        localSum += localProduct;
+    }
+
+    //Product of every earlier slice is (sp-1)!, which scales this slice's terms up to k!
+    unsigned long long prefixProduct = 1;
+    MPI_Exscan(&localProduct, &prefixProduct, 1, MPI_UNSIGNED_LONG_LONG, MPI_PROD, MPI_COMM_WORLD);
+    if (myrank == 0)
+        prefixProduct = 1; //MPI_Exscan leaves rank 0's result undefined
+    localSum *= prefixProduct;
+
+    //Add the partial sums of every slice on the root
+    unsigned long long total = 0;
+    MPI_Reduce(&localSum, &total, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    double end = MPI_Wtime();
+
+    if (myrank == 0){
+        if (N <= MAX_EXACT_N)
+            printf("Processor Rank %d: Sum of factorials 1! to %ld! is %llu \n", myrank, N, total);
+        else
+            printf("Processor Rank %d: Sum of factorials 1! to %ld! modulo 2^64 is %llu \n", myrank, N, total);
+        printf("Distributed over %d processors in %f s \n", numProcessors, end - start);
+    }
+}
+
+void exactSumFactorials(int myrank, int numProcessors, long N, int numThreads){
+    //Same contiguous slices of 1..N as the distributed mode
+    long npp = N / numProcessors; //npp = numbers per process
+    long nppr = N % numProcessors; //nppr = num per process remainder
+    long sp = myrank * npp + (myrank < nppr ? myrank : nppr) + 1; // Start point
+    long ep = sp + npp + (myrank < nppr ? 1 : 0); // End point (exclusive)
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double start = MPI_Wtime();
+
+    //P = product of the slice, T = sum of k!/(sp-1)! over the slice
+    //P only matters while slices to the right remain, so the last slice skips it
+    bignum P, T;
+    if (myrank + 1 < numProcessors)
+        bignumSplitRange(sp, ep, numThreads, &P, &T);
+    else {
+        bignumSet(&P, 1);
+        bignumSplitRange(sp, ep, numThreads, NULL, &T);
+    }
+
+    //Combine neighbouring slices up a binary tree: T = Tleft + Pleft * Tright
+    //and, when slices further right still need it, P = Pleft * Pright
+    for (int step = 1; step < numProcessors; step *= 2){
+        if (myrank % (2 * step) == 0){
+            if (myrank + step < numProcessors){
+                int needP = myrank + 2 * step < numProcessors;
+                bignum Pr, Tr, scaled, sum, product;
+                if (needP)
+                    recvBignum(&Pr, myrank + step);
+                recvBignum(&Tr, myrank + step);
+                bignumMul(&P, &Tr, &scaled);
+                bignumAdd(&T, &scaled, &sum);
+                bignumFree(&scaled);
+                bignumFree(&Tr);
+                bignumFree(&T);
+                T = sum;
+                if (needP){
+                    bignumMul(&P, &Pr, &product);
+                    bignumFree(&Pr);
+                    bignumFree(&P);
+                    P = product;
+                }
+            }
+        }
+        else {
+            //Hand this subtree's result to its parent and stop; the parent only
+            //wants P when more slices lie to the right of this subtree
+            if (myrank + step < numProcessors)
+                sendBignum(&P, myrank - step);
+            sendBignum(&T, myrank - step);
+            break;
+        }
+    }
+    double end = MPI_Wtime();
+
+    //Root streams the digits to a file
+    if (myrank == 0){
+        char filename[100];
+        sprintf(filename, "sumFactorials_%ld.txt", N);
+        FILE *fp = fopen(filename, "w+");
+        bignumWrite(fp, &T);
+        fprintf(fp, "\n");
+        fclose(fp);
+        printf("Processor Rank %d: Sum of factorials 1! to %ld! has %zu digits, written to %s \n", myrank, N, bignumDigits(&T), filename);
+        printf("Computed over %d processors with %d threads each in %f s \n", numProcessors, numThreads, end - start);
+    }
+    bignumFree(&P);
+    bignumFree(&T);
+}
+
+//Send the limb count then the limbs
+void sendBignum(const bignum *x, int dest){
+    unsigned long len = x->len;
+    MPI_Send(&len, 1, MPI_UNSIGNED_LONG, dest, 0, MPI_COMM_WORLD);
+    MPI_Send(x->limbs, (int)len, MPI_UINT32_T, dest, 0, MPI_COMM_WORLD);
+}
+
+void recvBignum(bignum *x, int source){
+    unsigned long len;
+    MPI_Status status;
+    MPI_Recv(&len, 1, MPI_UNSIGNED_LONG, source, 0, MPI_COMM_WORLD, &status);
+    x->len = len;
+    x->limbs = (uint32_t*)malloc((len > 0 ? len : 1) * sizeof(uint32_t));
+    MPI_Recv(x->limbs, (int)len, MPI_UINT32_T, source, 0, MPI_COMM_WORLD, &status);
+}
@@ -0,0 +1,301 @@
+/*
+ * Arbitrary-precision sum of factorials by parallel binary splitting.
+ *
+ * For a range [a, b) let P(a,b) = a*(a+1)*...*(b-1) and
+ * T(a,b) = a + a(a+1) + ... + a(a+1)...(b-1). Then 1! + ... + n! = T(1, n+1) and
+ * two halves [a,m) and [m,b) combine as
+ *     P(a,b) = P(a,m) * P(m,b)
+ *     T(a,b) = T(a,m) + P(a,m) * T(m,b)
+ * so the expensive work is a balanced tree of big multiplications. The top levels
+ * of the tree run on separate threads and multiplication switches from schoolbook
+ * to Karatsuba for large operands.
+ */
+#include "sumFactorials_bignum.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+//Operands shorter than this many limbs use schoolbook multiplication
+#define KARATSUBA_CUTOFF 40
+//Ranges shorter than this are multiplied out directly
+#define LEAF_SIZE 32
+
+typedef struct {
+	long a, b;
+	int numThreads;
+	bignum *P, *T;
+} splitTask;
+
+//Function Declarations
+static void mulSchool(uint32_t *r, const uint32_t *a, size_t na, const uint32_t *b, size_t nb);
+static void mulKaratsuba(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n);
+static void addTo(uint32_t *r, size_t nr, const uint32_t *a, size_t na);
+static void subFrom(uint32_t *r, size_t nr, const uint32_t *a, size_t na);
+static size_t trimmed(const uint32_t *x, size_t n);
+static void mulWord(bignum *x, uint32_t w);
+static void *splitFunc(void *pArg);
+
+void bignumSet(bignum *x, uint32_t v)
+{
+	x->limbs = (uint32_t*)malloc(2 * sizeof(uint32_t));
+	x->limbs[0] = v % BIGNUM_BASE;
+	x->limbs[1] = v / BIGNUM_BASE;
+	x->len = trimmed(x->limbs, 2);
+}
+
+void bignumFree(bignum *x)
+{
+	free(x->limbs);
+	x->limbs = NULL;
+	x->len = 0;
+}
+
+void bignumAdd(const bignum *a, const bignum *b, bignum *out)
+{
+	size_t n = (a->len > b->len ? a->len : b->len) + 1;
+	out->limbs = (uint32_t*)calloc(n, sizeof(uint32_t));
+	memcpy(out->limbs, a->limbs, a->len * sizeof(uint32_t));
+	addTo(out->limbs, n, b->limbs, b->len);
+	out->len = trimmed(out->limbs, n);
+}
+
+void bignumMul(const bignum *a, const bignum *b, bignum *out)
+{
+	//Make a the longer operand
+	if (a->len < b->len) {
+		const bignum *t = a;
+		a = b;
+		b = t;
+	}
+	size_t na = a->len, nb = b->len;
+	out->limbs = (uint32_t*)calloc(na + nb + 1, sizeof(uint32_t));
+	if (nb == 0) {
+		out->len = 0;
+		return;
+	}
+
+	if (nb < KARATSUBA_CUTOFF) {
+		mulSchool(out->limbs, a->limbs, na, b->limbs, nb);
+	}
+	else {
+		//Multiply a in nb-limb chunks so every Karatsuba call is balanced
+		uint32_t *chunk = (uint32_t*)calloc(nb, sizeof(uint32_t));
+		uint32_t *prod = (uint32_t*)malloc(2 * nb * sizeof(uint32_t));
+		for (size_t off = 0; off < na; off += nb) {
+			size_t len = (na - off < nb) ? na - off : nb;
+			memset(chunk, 0, nb * sizeof(uint32_t));
+			memcpy(chunk, a->limbs + off, len * sizeof(uint32_t));
+			mulKaratsuba(prod, chunk, b->limbs, nb);
+			addTo(out->limbs + off, na + nb + 1 - off, prod, trimmed(prod, 2 * nb));
+		}
+		free(chunk);
+		free(prod);
+	}
+	out->len = trimmed(out->limbs, na + nb + 1);
+}
+
+//r[0 .. na+nb) must be zero on entry
+static void mulSchool(uint32_t *r, const uint32_t *a, size_t na, const uint32_t *b, size_t nb)
+{
+	for (size_t i = 0; i < na; i++) {
+		uint64_t carry = 0;
+		uint64_t ai = a[i];
+		for (size_t j = 0; j < nb; j++) {
+			uint64_t t = ai * b[j] + r[i + j] + carry;
+			r[i + j] = (uint32_t)(t % BIGNUM_BASE);
+			carry = t / BIGNUM_BASE;
+		}
+		r[i + nb] = (uint32_t)carry;
+	}
+}
+
+//r[0 .. 2n) = a[0 .. n) * b[0 .. n)
+static void mulKaratsuba(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n)
+{
+	if (n < KARATSUBA_CUTOFF) {
+		memset(r, 0, 2 * n * sizeof(uint32_t));
+		mulSchool(r, a, n, b, n);
+		return;
+	}
+	size_t lo = n / 2, hi = n - lo;
+
+	//z0 = a0*b0 fills r[0 .. 2lo) and z2 = a1*b1 fills r[2lo .. 2n)
+	mulKaratsuba(r, a, b, lo);
+	mulKaratsuba(r + 2 * lo, a + lo, b + lo, hi);
+
+	//z1 = (a0+a1)(b0+b1) - z0 - z2, added in at r[lo]
+	uint32_t *sa = (uint32_t*)calloc(hi + 1, sizeof(uint32_t));
+	uint32_t *sb = (uint32_t*)calloc(hi + 1, sizeof(uint32_t));
+	uint32_t *z1 = (uint32_t*)malloc(2 * (hi + 1) * sizeof(uint32_t));
+	memcpy(sa, a + lo, hi * sizeof(uint32_t));
+	memcpy(sb, b + lo, hi * sizeof(uint32_t));
+	addTo(sa, hi + 1, a, lo);
+	addTo(sb, hi + 1, b, lo);
+	mulKaratsuba(z1, sa, sb, hi + 1);
+	subFrom(z1, 2 * (hi + 1), r, 2 * lo);
+	subFrom(z1, 2 * (hi + 1), r + 2 * lo, 2 * hi);
+	addTo(r + lo, 2 * n - lo, z1, trimmed(z1, 2 * (hi + 1)));
+	free(sa);
+	free(sb);
+	free(z1);
+}
+
+//r += a, where the sum is known to fit in nr limbs
+static void addTo(uint32_t *r, size_t nr, const uint32_t *a, size_t na)
+{
+	uint32_t carry = 0;
+	size_t i;
+	for (i = 0; i < na; i++) {
+		uint32_t t = r[i] + a[i] + carry;
+		carry = t >= BIGNUM_BASE;
+		r[i] = carry ? t - BIGNUM_BASE : t;
+	}
+	for (; carry && i < nr; i++) {
+		uint32_t t = r[i] + 1;
+		carry = t >= BIGNUM_BASE;
+		r[i] = carry ? 0 : t;
+	}
+}
+
+//r -= a, where r >= a
+static void subFrom(uint32_t *r, size_t nr, const uint32_t *a, size_t na)
+{
+	uint32_t borrow = 0;
+	size_t i;
+	for (i = 0; i < na; i++) {
+		uint32_t s = a[i] + borrow;
+		borrow = r[i] < s;
+		r[i] = borrow ? r[i] + BIGNUM_BASE - s : r[i] - s;
+	}
+	for (; borrow && i < nr; i++) {
+		borrow = r[i] == 0;
+		r[i] = borrow ? BIGNUM_BASE - 1 : r[i] - 1;
+	}
+}
+
+//Length of x without leading zero limbs
+static size_t trimmed(const uint32_t *x, size_t n)
+{
+	while (n > 0 && x[n - 1] == 0)
+		n--;
+	return n;
+}
+
+//x *= w in place, growing x as needed
+static void mulWord(bignum *x, uint32_t w)
+{
+	uint64_t carry = 0;
+	for (size_t i = 0; i < x->len; i++) {
+		uint64_t t = (uint64_t)x->limbs[i] * w + carry;
+		x->limbs[i] = (uint32_t)(t % BIGNUM_BASE);
+		carry = t / BIGNUM_BASE;
+	}
+	while (carry) {
+		x->limbs = (uint32_t*)realloc(x->limbs, (x->len + 1) * sizeof(uint32_t));
+		x->limbs[x->len++] = (uint32_t)(carry % BIGNUM_BASE);
+		carry /= BIGNUM_BASE;
+	}
+}
+
+static void *splitFunc(void *pArg)
+{
+	splitTask *task = (splitTask*)pArg;
+	bignumSplitRange(task->a, task->b, task->numThreads, task->P, task->T);
+	return NULL;
+}
+
+void bignumSplitRange(long a, long b, int numThreads, bignum *P, bignum *T)
+{
+	//Small ranges: T accumulates the running product
+	if (b - a <= LEAF_SIZE) {
+		bignum prod, sum;
+		bignumSet(&prod, 1);
+		bignumSet(&sum, 0);
+		for (long k = a; k < b; k++) {
+			mulWord(&prod, (uint32_t)k);
+			bignum next;
+			bignumAdd(&sum, &prod, &next);
+			bignumFree(&sum);
+			sum = next;
+		}
+		*T = sum;
+		if (P != NULL)
+			*P = prod;
+		else
+			bignumFree(&prod);
+		return;
+	}
+
+	//The left half's product is always needed to scale the right half's sum
+	long m = a + (b - a) / 2;
+	bignum Pl, Tl, Pr, Tr;
+	if (numThreads > 1) {
+		//Run the right half on a new thread with half of the thread budget
+		splitTask right = { m, b, numThreads / 2, P != NULL ? &Pr : NULL, &Tr };
+		pthread_t tid;
+		pthread_create(&tid, NULL, splitFunc, &right);
+		bignumSplitRange(a, m, numThreads - numThreads / 2, &Pl, &Tl);
+		pthread_join(tid, NULL);
+	}
+	else {
+		bignumSplitRange(a, m, 1, &Pl, &Tl);
+		bignumSplitRange(m, b, 1, P != NULL ? &Pr : NULL, &Tr);
+	}
+
+	bignum scaled;
+	bignumMul(&Pl, &Tr, &scaled);
+	bignumAdd(&Tl, &scaled, T);
+	bignumFree(&scaled);
+	bignumFree(&Tl);
+	bignumFree(&Tr);
+	if (P != NULL) {
+		bignumMul(&Pl, &Pr, P);
+		bignumFree(&Pr);
+	}
+	bignumFree(&Pl);
+}
+
+void bignumSumFactorials(long n, int numThreads, bignum *result)
+{
+	if (n < 1) {
+		bignumSet(result, 0);
+		return;
+	}
+	bignumSplitRange(1, n + 1, numThreads, NULL, result);
+}
+
+size_t bignumDigits(const bignum *x)
+{
+	if (x->len == 0)
+		return 1;
+	size_t digits = (x->len - 1) * BIGNUM_BASE_DIGITS;
+	for (uint32_t top = x->limbs[x->len - 1]; top > 0; top /= 10)
+		digits++;
+	return digits;
+}
+
+//Stream the digits most significant limb first
+void bignumWrite(FILE *fp, const bignum *x)
+{
+	if (x->len == 0) {
+		fputc('0', fp);
+		return;
+	}
+	fprintf(fp, "%u", x->limbs[x->len - 1]);
+	for (size_t i = x->len - 1; i-- > 0; )
+		fprintf(fp, "%09u", x->limbs[i]);
+}
+
+char *bignumToString(const bignum *x)
+{
+	size_t digits = bignumDigits(x);
+	char *s = (char*)malloc(digits + BIGNUM_BASE_DIGITS + 1);
+	if (x->len == 0) {
+		strcpy(s, "0");
+		return s;
+	}
+	char *p = s + sprintf(s, "%u", x->limbs[x->len - 1]);
+	for (size_t i = x->len - 1; i-- > 0; )
+		p += sprintf(p, "%09u", x->limbs[i]);
+	return s;
+}
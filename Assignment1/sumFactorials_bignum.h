@@ -0,0 +1,45 @@
+/*
+ * Arbitrary-precision sum of factorials.
+ *
+ * Numbers are stored little-endian in base 10^9 so the decimal result can be
+ * streamed out limb by limb without a base conversion.
+ *
+ * GMP is installed (Week5's Chudnovsky program links it), but this stays
+ * self-contained on purpose: the rpcgen Makefile builds the servers with only
+ * -lnsl -lpthread, and the digits the RPC and MPI programs send are decimal
+ * already rather than converted from GMP's binary limbs on every call.
+ */
+#ifndef SUMFACTORIALS_BIGNUM_H
+#define SUMFACTORIALS_BIGNUM_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#define BIGNUM_BASE 1000000000u
+#define BIGNUM_BASE_DIGITS 9
+
+typedef struct {
+	uint32_t *limbs;	//Least significant limb first
+	size_t len;		//0 for the value zero
+} bignum;
+
+//Initialise x to the small value v
+void bignumSet(bignum *x, uint32_t v);
+void bignumFree(bignum *x);
+//out = a + b and out = a * b; out must not alias a or b
+void bignumAdd(const bignum *a, const bignum *b, bignum *out);
+void bignumMul(const bignum *a, const bignum *b, bignum *out);
+
+//Binary splitting over [a, b): P = a*(a+1)*...*(b-1) and T = sum over k of a*...*k
+//P may be NULL when the product is not needed. Uses up to numThreads threads.
+void bignumSplitRange(long a, long b, int numThreads, bignum *P, bignum *T);
+//result = 1! + 2! + ... + n!
+void bignumSumFactorials(long n, int numThreads, bignum *result);
+
+//Decimal output
+size_t bignumDigits(const bignum *x);
+void bignumWrite(FILE *fp, const bignum *x);
+char *bignumToString(const bignum *x);
+
+#endif
@@ -1,17 +1,25 @@
 
 #include "sumFactorials.h"
+#include "sumFactorials_local.h"
+#include <string.h>
+#include <time.h>
 
+//Largest batch that still fits the reply in one UDP datagram (UDPMSGSIZE is 8800 bytes)
+#define MAX_UDP_BATCH 1000
+
+double elapsedSeconds(struct timespec start, struct timespec end);
 
 void
 sum_prog_1(char *host,int x)
 {   
 	CLIENT *clnt;
-	long  *result_1;
+	enum clnt_stat retval_1;
+	long result_1;
 	number  sumfactorial_1_arg;
 
-    //Create client and server connection
+    //Create client and server connection, over the Unix socket when the server is on this host
 #ifndef	DEBUG
-	clnt = clnt_create (host, SUM_PROG, SUM_VERS, "udp");
+	clnt = sumClientCreate (host, SUM_VERS, "udp");
 	if (clnt == NULL) {
 		clnt_pcreateerror (host);
 		exit (1);
@@ -20,15 +28,15 @@ sum_prog_1(char *host,int x)
     //Pass the parameter into the number struct defined in sumFactorials.x
 	sumfactorial_1_arg.x=x;
 	//Remote process call to server and store result
-	result_1 = sumfactorial_1(&sumfactorial_1_arg, clnt);
+	retval_1 = sumfactorial_1(&sumfactorial_1_arg, &result_1, clnt);
 	
 	//Check whether the result succeeded
-	if (result_1 == (long *) NULL) {
+	if (retval_1 != RPC_SUCCESS) {
 		clnt_perror (clnt, "call failed");
 	}
 	else{
 	    //Print out result obtained from server
-	    printf("Result: %ld \n", *result_1);
+	    printf("Result: %ld \n", result_1);
 	}
 
 #ifndef	DEBUG
@@ -37,6 +45,172 @@ sum_prog_1(char *host,int x)
 }
 
 
+void
+sum_prog_2_batch(char *host, int batchSize)
+{
+	CLIENT *clnt1, *clnt2;
+	long  result_1;
+	resultList  result_2;
+	number  sumfactorial_1_arg;
+	numberList  sumfactorialbatch_2_arg;
+	struct timespec start, end;
+	double perItemTime, batchTime;
+	int count = 0, capacity = 1024, calls = 0, x;
+
+	//Read every value of N from standard input
+	int *values = (int*)malloc(capacity * sizeof(int));
+	while (scanf("%d", &x) == 1){
+		if (count == capacity){
+			capacity *= 2;
+			values = (int*)realloc(values, capacity * sizeof(int));
+		}
+		values[count++] = x;
+	}
+	if (count == 0){
+		printf("No values of N read from standard input \n");
+		free(values);
+		return;
+	}
+	long *perItemResults = (long*)malloc(count * sizeof(long));
+	quad_t *batchResults = (quad_t*)malloc(count * sizeof(quad_t));
+
+	//Create client and server connection for both versions
+	clnt1 = sumClientCreate (host, SUM_VERS, "udp");
+	if (clnt1 == NULL) {
+		clnt_pcreateerror (host);
+		exit (1);
+	}
+	clnt2 = sumClientCreate (host, SUM_BATCH_VERS, "udp");
+	if (clnt2 == NULL) {
+		clnt_pcreateerror (host);
+		exit (1);
+	}
+
+	//Per-item calls: one round trip for every N
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int i=0; i<count; i++){
+		sumfactorial_1_arg.x = values[i];
+		if (sumfactorial_1(&sumfactorial_1_arg, &result_1, clnt1) != RPC_SUCCESS) {
+			clnt_perror (clnt1, "call failed");
+			exit (1);
+		}
+		perItemResults[i] = result_1;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	perItemTime = elapsedSeconds(start, end);
+
+	//Batched calls: one round trip for every batchSize values of N
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int i=0; i<count; i+=batchSize){
+		sumfactorialbatch_2_arg.numberList_val = values + i;
+		sumfactorialbatch_2_arg.numberList_len = (count - i < batchSize) ? count - i : batchSize;
+		memset(&result_2, 0, sizeof(result_2));
+		if (sumfactorialbatch_2(&sumfactorialbatch_2_arg, &result_2, clnt2) != RPC_SUCCESS) {
+			clnt_perror (clnt2, "call failed");
+			exit (1);
+		}
+		calls++;
+		if (result_2.resultList_len != sumfactorialbatch_2_arg.numberList_len) {
+			printf("Server returned %u results for %u values \n", result_2.resultList_len, sumfactorialbatch_2_arg.numberList_len);
+			exit (1);
+		}
+
+		//Keep the results for printing once the timing is done
+		memcpy(batchResults + i, result_2.resultList_val, result_2.resultList_len * sizeof(quad_t));
+		//Release the array the XDR decoding allocated
+		xdr_free((xdrproc_t) xdr_resultList, (char *) &result_2);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	batchTime = elapsedSeconds(start, end);
+
+	//Print each result and check it against the per-item answer
+	//Version 1 returns an XDR long, which is only 32 bits on the wire, so N > 12 will differ
+	for (int i=0; i<count; i++){
+		printf("sumFactorial(%d) = %lld \n", values[i], (long long)batchResults[i]);
+		if (batchResults[i] != perItemResults[i])
+			printf("Per-item result for N = %d differs: %ld \n", values[i], perItemResults[i]);
+	}
+
+	//Report throughput of both modes
+	printf("Per-item: %d calls for %d values in %f s (%.1f values/s) \n", count, count, perItemTime, count / perItemTime);
+	printf("Batched:  %d calls for %d values in %f s (%.1f values/s), batch size %d \n", calls, count, batchTime, count / batchTime, batchSize);
+	printf("Speedup of batched over per-item calls: %.2fx \n", perItemTime / batchTime);
+
+	clnt_destroy (clnt1);
+	clnt_destroy (clnt2);
+	free(perItemResults);
+	free(batchResults);
+	free(values);
+}
+
+
+void
+sum_prog_3_exact(char *host, int x)
+{
+	CLIENT *clnt;
+	digitString result_3 = NULL;
+	number  sumfactorialexact_3_arg;
+	struct timespec start, end;
+
+	//The digit string outgrows a UDP datagram for N above a few thousand, so use TCP
+	clnt = sumClientCreate (host, SUM_EXACT_VERS, "tcp");
+	if (clnt == NULL) {
+		clnt_pcreateerror (host);
+		exit (1);
+	}
+
+	sumfactorialexact_3_arg.x = x;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	if (sumfactorialexact_3(&sumfactorialexact_3_arg, &result_3, clnt) != RPC_SUCCESS) {
+		clnt_perror (clnt, "call failed");
+	}
+	else if (result_3[0] == '\0') {
+		printf("N = %d is out of range for sumFactorialExact \n", x);
+	}
+	else {
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		//Print out exact result obtained from server
+		printf("Result: %s \n", result_3);
+		fprintf(stderr, "%zu digits in %f s \n", strlen(result_3), elapsedSeconds(start, end));
+	}
+	xdr_free((xdrproc_t) xdr_digitString, (char *) &result_3);
+	clnt_destroy (clnt);
+}
+
+
+void
+sum_prog_4_mod(char *host, long long x, unsigned long long p)
+{
+	CLIENT *clnt;
+	u_quad_t result_4;
+	modNumber  sumfactorialmod_4_arg;
+	struct timespec start, end;
+
+	clnt = sumClientCreate (host, SUM_MOD_VERS, "udp");
+	if (clnt == NULL) {
+		clnt_pcreateerror (host);
+		exit (1);
+	}
+
+	sumfactorialmod_4_arg.x = x;
+	sumfactorialmod_4_arg.p = p;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	if (sumfactorialmod_4(&sumfactorialmod_4_arg, &result_4, clnt) != RPC_SUCCESS) {
+		clnt_perror (clnt, "call failed");
+	}
+	else if (result_4 == MOD_OUT_OF_RANGE) {
+		printf("N = %lld is out of range for sumFactorialMod (0 to %d) \n", x, MAX_MOD_N);
+	}
+	else {
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		//Print out result obtained from server and the round trip time
+		printf("Result: %llu \n", (unsigned long long)result_4);
+		printf("Call took %f s \n", elapsedSeconds(start, end));
+	}
+	clnt_destroy (clnt);
+}
+
+
 int
 main (int argc, char *argv[])
 {
@@ -44,12 +218,41 @@ main (int argc, char *argv[])
     //Check that program is called properly
 	if (argc < 3) {
 		printf ("usage: %s ./sumFactorials_client server_host NUMBER \n", argv[0]);
+		printf ("       %s ./sumFactorials_client server_host -b BATCH_SIZE < values.txt \n", argv[0]);
+		printf ("       %s ./sumFactorials_client server_host -e NUMBER \n", argv[0]);
+		printf ("       %s ./sumFactorials_client server_host -m NUMBER MODULUS \n", argv[0]);
 		exit (1);
 	}
 	//Set host from first parameter
 	host = argv[1];
+
+	//Batch mode reads the values of N from standard input
+	if (strcmp(argv[2], "-b") == 0) {
+		int batchSize = (argc > 3) ? atoi(argv[3]) : 100;
+		if (batchSize < 1 || batchSize > MAX_UDP_BATCH) {
+			printf ("BATCH_SIZE must be between 1 and %d \n", MAX_UDP_BATCH);
+			exit (1);
+		}
+		sum_prog_2_batch (host, batchSize);
+		exit (0);
+	}
+	//Exact mode returns every digit of the sum
+	if (strcmp(argv[2], "-e") == 0 && argc > 3) {
+		sum_prog_3_exact (host, atoi(argv[3]));
+		exit (0);
+	}
+	//Modular mode returns the sum of factorials modulo MODULUS
+	if (strcmp(argv[2], "-m") == 0 && argc > 4) {
+		sum_prog_4_mod (host, atoll(argv[3]), strtoull(argv[4], NULL, 10));
+		exit (0);
+	}
     //Call main program
 	sum_prog_1 (host, atoi(argv[2]));
 
 exit (0);
 }
+
+//Time between two CLOCK_MONOTONIC readings in seconds
+double elapsedSeconds(struct timespec start, struct timespec end){
+	return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+}
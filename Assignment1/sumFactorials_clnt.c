@@ -9,17 +9,92 @@
 /* Default timeout can be changed using clnt_control() */
 static struct timeval TIMEOUT = { 25, 0 };
 
-long *
-sumfactorial_1(number *argp, CLIENT *clnt)
+enum clnt_stat 
+sumfactorial_1(number *argp, long *clnt_res, CLIENT *clnt)
 {
-	static long clnt_res;
+	return (clnt_call(clnt, sumFactorial,
+		(xdrproc_t) xdr_number, (caddr_t) argp,
+		(xdrproc_t) xdr_long, (caddr_t) clnt_res,
+		TIMEOUT));
+}
+
+enum clnt_stat 
+sumfactorial_2(number *argp, long *clnt_res, CLIENT *clnt)
+{
+	return (clnt_call(clnt, sumFactorial,
+		(xdrproc_t) xdr_number, (caddr_t) argp,
+		(xdrproc_t) xdr_long, (caddr_t) clnt_res,
+		TIMEOUT));
+}
+
+enum clnt_stat 
+sumfactorialbatch_2(numberList *argp, resultList *clnt_res, CLIENT *clnt)
+{
+	return (clnt_call(clnt, sumFactorialBatch,
+		(xdrproc_t) xdr_numberList, (caddr_t) argp,
+		(xdrproc_t) xdr_resultList, (caddr_t) clnt_res,
+		TIMEOUT));
+}
 
-	memset((char *)&clnt_res, 0, sizeof(clnt_res));
-	if (clnt_call (clnt, sumFactorial,
+enum clnt_stat 
+sumfactorial_3(number *argp, long *clnt_res, CLIENT *clnt)
+{
+	return (clnt_call(clnt, sumFactorial,
 		(xdrproc_t) xdr_number, (caddr_t) argp,
-		(xdrproc_t) xdr_long, (caddr_t) &clnt_res,
-		TIMEOUT) != RPC_SUCCESS) {
-		return (NULL);
-	}
-	return (&clnt_res);
+		(xdrproc_t) xdr_long, (caddr_t) clnt_res,
+		TIMEOUT));
+}
+
+enum clnt_stat 
+sumfactorialbatch_3(numberList *argp, resultList *clnt_res, CLIENT *clnt)
+{
+	return (clnt_call(clnt, sumFactorialBatch,
+		(xdrproc_t) xdr_numberList, (caddr_t) argp,
+		(xdrproc_t) xdr_resultList, (caddr_t) clnt_res,
+		TIMEOUT));
+}
+
+enum clnt_stat 
+sumfactorialexact_3(number *argp, digitString *clnt_res, CLIENT *clnt)
+{
+	return (clnt_call(clnt, sumFactorialExact,
+		(xdrproc_t) xdr_number, (caddr_t) argp,
+		(xdrproc_t) xdr_digitString, (caddr_t) clnt_res,
+		TIMEOUT));
+}
+
+enum clnt_stat 
+sumfactorial_4(number *argp, long *clnt_res, CLIENT *clnt)
+{
+	return (clnt_call(clnt, sumFactorial,
+		(xdrproc_t) xdr_number, (caddr_t) argp,
+		(xdrproc_t) xdr_long, (caddr_t) clnt_res,
+		TIMEOUT));
+}
+
+enum clnt_stat 
+sumfactorialbatch_4(numberList *argp, resultList *clnt_res, CLIENT *clnt)
+{
+	return (clnt_call(clnt, sumFactorialBatch,
+		(xdrproc_t) xdr_numberList, (caddr_t) argp,
+		(xdrproc_t) xdr_resultList, (caddr_t) clnt_res,
+		TIMEOUT));
+}
+
+enum clnt_stat 
+sumfactorialexact_4(number *argp, digitString *clnt_res, CLIENT *clnt)
+{
+	return (clnt_call(clnt, sumFactorialExact,
+		(xdrproc_t) xdr_number, (caddr_t) argp,
+		(xdrproc_t) xdr_digitString, (caddr_t) clnt_res,
+		TIMEOUT));
+}
+
+enum clnt_stat 
+sumfactorialmod_4(modNumber *argp, u_quad_t *clnt_res, CLIENT *clnt)
+{
+	return (clnt_call(clnt, sumFactorialMod,
+		(xdrproc_t) xdr_modNumber, (caddr_t) argp,
+		(xdrproc_t) xdr_u_quad_t, (caddr_t) clnt_res,
+		TIMEOUT));
 }
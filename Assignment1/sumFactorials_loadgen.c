@@ -0,0 +1,281 @@
+/*
+ * Load generator for the sumFactorial RPC service.
+ *
+ * Each of CONCURRENCY threads owns its own client handle and repeatedly calls
+ * sumFactorial with N drawn uniformly from [N_MIN, N_MAX]. Without -r the threads
+ * run closed-loop (next call as soon as the previous reply arrives). With -r the
+ * load is open-loop: calls are scheduled at fixed intervals to reach RATE calls/s
+ * in total, and latency is measured from the scheduled start so a slow server is
+ * not hidden by the generator waiting on it.
+ *
+ * usage: sumFactorials_loadgen server_host [-c CONCURRENCY] [-n N_MIN-N_MAX]
+ *            [-p auto|local|udp|tcp] [-d SECONDS] [-r RATE] [-t TIMEOUT_MS]
+ *
+ * Transport "auto" (the default) uses the Unix socket for a server on this host
+ * and UDP otherwise; "local" forces the Unix socket and "udp"/"tcp" force the network.
+ */
+
+#include "sumFactorials.h"
+#include "sumFactorials_local.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_THREADS 1024
+//Latency histogram: 2^SUB_BITS linear buckets within every power of two microseconds
+#define SUB_BITS 4
+#define SUB_BUCKETS (1 << SUB_BITS)
+#define NUM_BUCKETS (64 * SUB_BUCKETS)
+
+typedef struct {
+	long long buckets[NUM_BUCKETS];
+	long long count;
+	long long maxUs;
+	double sumUs;
+} histogram;
+
+typedef struct {
+	int id;
+	long long calls;
+	long long errors;
+	long long timeouts;
+	histogram hist;
+} threadStats;
+
+//Settings shared by every load thread
+static char *host;
+static char *transport = "auto";
+static int concurrency = 1;
+static int nMin = 1, nMax = 20;
+static double duration = 10.0;
+static double targetRate = 0.0;	//0 = closed loop
+static int timeoutMs = 1000;
+static struct timespec startTime;
+
+//Function Declarations
+void *loadFunc(void *pArg);
+CLIENT *createClient(void);
+void recordLatency(histogram *h, long long us);
+long long percentile(histogram *h, double p);
+int bucketIndex(long long us);
+long long bucketUpperBound(int index);
+double elapsedSeconds(struct timespec start, struct timespec end);
+void addSeconds(struct timespec *t, double seconds);
+
+int
+main (int argc, char *argv[])
+{
+	if (argc < 2) {
+		printf ("usage: %s server_host [-c CONCURRENCY] [-n N_MIN-N_MAX] [-p auto|local|udp|tcp] [-d SECONDS] [-r RATE] [-t TIMEOUT_MS] \n", argv[0]);
+		exit (1);
+	}
+	host = argv[1];
+
+	//Parse options
+	for (int i = 2; i + 1 < argc; i += 2) {
+		if (strcmp(argv[i], "-c") == 0)
+			concurrency = atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "-n") == 0) {
+			if (sscanf(argv[i + 1], "%d-%d", &nMin, &nMax) == 1)
+				nMax = nMin;
+		}
+		else if (strcmp(argv[i], "-p") == 0)
+			transport = argv[i + 1];
+		else if (strcmp(argv[i], "-d") == 0)
+			duration = atof(argv[i + 1]);
+		else if (strcmp(argv[i], "-r") == 0)
+			targetRate = atof(argv[i + 1]);
+		else if (strcmp(argv[i], "-t") == 0)
+			timeoutMs = atoi(argv[i + 1]);
+		else {
+			printf ("unknown option %s \n", argv[i]);
+			exit (1);
+		}
+	}
+	if (concurrency < 1 || concurrency > MAX_THREADS || nMin > nMax || duration <= 0
+	    || (strcmp(transport, "udp") != 0 && strcmp(transport, "tcp") != 0
+	        && strcmp(transport, "local") != 0 && strcmp(transport, "auto") != 0)) {
+		printf ("invalid options \n");
+		exit (1);
+	}
+
+	printf("Load: %d threads, %s, N in [%d, %d], %.1f s, %s", concurrency, transport, nMin, nMax, duration, targetRate > 0 ? "open loop at " : "closed loop \n");
+	if (targetRate > 0)
+		printf("%.1f calls/s \n", targetRate);
+
+	//Fork
+	pthread_t tid[MAX_THREADS];
+	threadStats *stats = (threadStats*)calloc(concurrency, sizeof(threadStats));
+	clock_gettime(CLOCK_MONOTONIC, &startTime);
+	for (int i = 0; i < concurrency; i++) {
+		stats[i].id = i;
+		pthread_create(&tid[i], NULL, loadFunc, &stats[i]);
+	}
+
+	//Join and merge the per-thread results
+	threadStats total;
+	memset(&total, 0, sizeof(total));
+	for (int i = 0; i < concurrency; i++) {
+		pthread_join(tid[i], NULL);
+		total.calls += stats[i].calls;
+		total.errors += stats[i].errors;
+		total.timeouts += stats[i].timeouts;
+		for (int b = 0; b < NUM_BUCKETS; b++)
+			total.hist.buckets[b] += stats[i].hist.buckets[b];
+		total.hist.count += stats[i].hist.count;
+		total.hist.sumUs += stats[i].hist.sumUs;
+		if (stats[i].hist.maxUs > total.hist.maxUs)
+			total.hist.maxUs = stats[i].hist.maxUs;
+	}
+	struct timespec endTime;
+	clock_gettime(CLOCK_MONOTONIC, &endTime);
+	double elapsed = elapsedSeconds(startTime, endTime);
+
+	//Report throughput, failures and latency
+	histogram *h = &total.hist;
+	//Only replies count towards throughput; failed calls are listed on their own
+	printf("Throughput: %lld succeeded in %f s (%.1f calls/s) \n", h->count, elapsed, h->count / elapsed);
+	printf("Failed: %lld of %lld calls (Errors: %lld  Timeouts: %lld) \n", total.errors + total.timeouts, total.calls, total.errors, total.timeouts);
+	if (h->count > 0) {
+		printf("Latency (us): mean %.1f  p50 %lld  p90 %lld  p99 %lld  p999 %lld  max %lld \n",
+		       h->sumUs / h->count, percentile(h, 0.50), percentile(h, 0.90), percentile(h, 0.99), percentile(h, 0.999), h->maxUs);
+		printf("Latency histogram (us): \n");
+		for (int p = 0; p < 64; p++) {
+			long long count = 0;
+			for (int s = 0; s < SUB_BUCKETS; s++)
+				count += h->buckets[p * SUB_BUCKETS + s];
+			if (count > 0)
+				printf("  < %10lld : %lld \n", bucketUpperBound(p * SUB_BUCKETS + SUB_BUCKETS - 1), count);
+		}
+	}
+	free(stats);
+	exit (0);
+}
+
+void *loadFunc(void *pArg)
+{
+	threadStats *stats = (threadStats*)pArg;
+	unsigned int seed = 12345u + stats->id;
+	struct timeval timeout = { timeoutMs / 1000, (timeoutMs % 1000) * 1000 };
+	struct timespec scheduled = startTime, sent, done;
+	double interval = targetRate > 0 ? concurrency / targetRate : 0;
+	number arg;
+	long result;
+
+	//Every thread needs its own handle; the -M stubs keep no shared state
+	CLIENT *clnt = createClient();
+	if (clnt == NULL) {
+		clnt_pcreateerror (host);
+		return NULL;
+	}
+	clnt_control(clnt, CLSET_TIMEOUT, (char *)&timeout);
+
+	//Stagger the open-loop schedules so threads do not fire together
+	if (interval > 0)
+		addSeconds(&scheduled, interval * stats->id / concurrency);
+
+	while (1) {
+		if (interval > 0) {
+			//Open loop: wait for this call's slot, but never skip a slot that is already late
+			clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &scheduled, NULL);
+			sent = scheduled;
+			addSeconds(&scheduled, interval);
+		}
+		else {
+			clock_gettime(CLOCK_MONOTONIC, &sent);
+		}
+		if (elapsedSeconds(startTime, sent) >= duration)
+			break;
+
+		arg.x = nMin + (int)(rand_r(&seed) % (unsigned)(nMax - nMin + 1));
+		enum clnt_stat stat = sumfactorial_1(&arg, &result, clnt);
+		clock_gettime(CLOCK_MONOTONIC, &done);
+		stats->calls++;
+
+		if (stat == RPC_SUCCESS) {
+			recordLatency(&stats->hist, (long long)(elapsedSeconds(sent, done) * 1e6));
+		}
+		else if (stat == RPC_TIMEDOUT) {
+			stats->timeouts++;
+		}
+		else {
+			stats->errors++;
+			//A failed stream cannot be reused, so reconnect
+			if (strcmp(transport, "udp") != 0) {
+				clnt_destroy(clnt);
+				clnt = createClient();
+				if (clnt == NULL)
+					return NULL;
+				clnt_control(clnt, CLSET_TIMEOUT, (char *)&timeout);
+			}
+		}
+	}
+	clnt_destroy(clnt);
+	return NULL;
+}
+
+CLIENT *createClient(void)
+{
+	if (strcmp(transport, "udp") == 0 || strcmp(transport, "tcp") == 0)
+		return clnt_create (host, SUM_PROG, SUM_VERS, transport);
+	return sumClientCreate (host, SUM_VERS, strcmp(transport, "local") == 0 ? "local" : "udp");
+}
+
+//Buckets are exact below SUB_BUCKETS us, then SUB_BUCKETS per power of two
+int bucketIndex(long long us)
+{
+	if (us < SUB_BUCKETS)
+		return (int)us;
+	int power = 63 - __builtin_clzll((unsigned long long)us);
+	int sub = (int)((us >> (power - SUB_BITS)) & (SUB_BUCKETS - 1));
+	return (power - SUB_BITS + 1) * SUB_BUCKETS + sub;
+}
+
+long long bucketUpperBound(int index)
+{
+	if (index < SUB_BUCKETS)
+		return index + 1;
+	int power = index / SUB_BUCKETS + SUB_BITS - 1;
+	int sub = index % SUB_BUCKETS;
+	return (1LL << power) + ((long long)(sub + 1) << (power - SUB_BITS));
+}
+
+void recordLatency(histogram *h, long long us)
+{
+	if (us < 0)
+		us = 0;
+	h->buckets[bucketIndex(us)]++;
+	h->count++;
+	h->sumUs += us;
+	if (us > h->maxUs)
+		h->maxUs = us;
+}
+
+//Upper bound of the bucket holding the p-th fraction of samples
+long long percentile(histogram *h, double p)
+{
+	long long target = (long long)(p * h->count);
+	long long seen = 0;
+	if (target >= h->count)
+		target = h->count - 1;
+	for (int b = 0; b < NUM_BUCKETS; b++) {
+		seen += h->buckets[b];
+		if (seen > target)
+			return bucketUpperBound(b) < h->maxUs ? bucketUpperBound(b) : h->maxUs;
+	}
+	return h->maxUs;
+}
+
+double elapsedSeconds(struct timespec start, struct timespec end)
+{
+	return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+}
+
+void addSeconds(struct timespec *t, double seconds)
+{
+	long long ns = t->tv_nsec + (long long)(seconds * 1e9);
+	t->tv_sec += ns / 1000000000LL;
+	t->tv_nsec = ns % 1000000000LL;
+}
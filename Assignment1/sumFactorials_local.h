@@ -0,0 +1,29 @@
+/*
+ * Same-host transport for SUM_PROG over a Unix domain socket.
+ */
+#ifndef SUMFACTORIALS_LOCAL_H
+#define SUMFACTORIALS_LOCAL_H
+
+#include <stddef.h>
+#include <rpc/rpc.h>
+
+//Environment variable giving the socket path, for a server and its clients to agree on
+#define SUM_LOCAL_ENV "SUM_LOCAL_SOCKET"
+//Otherwise the socket lives in a directory only its user can enter (%u is the user id)
+#define SUM_LOCAL_DIR_FORMAT "/tmp/sumFactorials-%u"
+#define SUM_LOCAL_NAME "sumFactorials.sock"
+
+//Path of the socket for the user running this program. Without SUM_LOCAL_ENV the
+//default directory must belong to this user with no group or other access; the
+//server passes createDir = 1 to make it. Returns 0 when there is no usable path.
+int sumLocalPath(char *path, size_t len, int createDir);
+
+//1 when host names this machine
+int isLocalHost(const char *host);
+
+//Like clnt_create for SUM_PROG, but a host on this machine is reached over the Unix
+//socket when a server run by the same user is listening there; proto ("udp" or
+//"tcp") is used otherwise. proto "local" uses the Unix socket only.
+CLIENT *sumClientCreate(char *host, rpcvers_t vers, char *proto);
+
+#endif
@@ -0,0 +1,191 @@
+/*
+ * Sum of factorials modulo p.
+ *
+ * For odd p every product is a 64-bit Montgomery multiplication (no division in
+ * the loop). k is kept in Montgomery form by adding R mod p each step, so the
+ * loop is one multiply-reduce and two modular additions per term. Since p divides
+ * k! for every k >= p, and the running factorial stays 0 once it reaches 0, the
+ * loop stops early at min(n, p - 1) or at the first zero factorial.
+ *
+ * Results are cached in a hash table of (n, p) keys threaded on a doubly linked
+ * list in recency order, guarded by one mutex.
+ */
+#include "sumFactorials_mod.h"
+#include <stdlib.h>
+#include <pthread.h>
+
+#define HASH_BUCKETS (2 * MOD_CACHE_CAPACITY)
+
+typedef unsigned __int128 u128;
+
+typedef struct cacheEntry {
+	uint64_t n, p, value;
+	struct cacheEntry *prev, *next;	//Recency list, most recent first
+	struct cacheEntry *chain;	//Hash bucket chain
+} cacheEntry;
+
+static cacheEntry *buckets[HASH_BUCKETS];
+static cacheEntry *mostRecent = NULL, *leastRecent = NULL;
+static int cacheSize = 0;
+static modCacheStats cacheStats;
+static pthread_mutex_t cacheLock = PTHREAD_MUTEX_INITIALIZER;
+
+//Function Declarations
+static uint64_t montMul(uint64_t a, uint64_t b, uint64_t p, uint64_t pInv);
+static uint64_t addMod(uint64_t a, uint64_t b, uint64_t p);
+static uint64_t sumFactorialsModEven(uint64_t n, uint64_t p);
+static unsigned hashKey(uint64_t n, uint64_t p);
+static void unlinkEntry(cacheEntry *e);
+static void pushFront(cacheEntry *e);
+
+//a * b * 2^-64 mod p, for odd p and a, b < p, where pInv = p^-1 mod 2^64
+static uint64_t montMul(uint64_t a, uint64_t b, uint64_t p, uint64_t pInv)
+{
+	u128 t = (u128)a * b;
+	uint64_t m = (uint64_t)t * pInv;
+	uint64_t mpHigh = (uint64_t)(((u128)m * p) >> 64);
+	uint64_t tHigh = (uint64_t)(t >> 64);
+	//Low halves of t and m*p are equal, so t - m*p is just the difference of the high halves
+	return tHigh >= mpHigh ? tHigh - mpHigh : tHigh - mpHigh + p;
+}
+
+static uint64_t addMod(uint64_t a, uint64_t b, uint64_t p)
+{
+	uint64_t s = a + b;
+	return (s < a || s >= p) ? s - p : s;
+}
+
+uint64_t sumFactorialsMod(uint64_t n, uint64_t p)
+{
+	if (p == 1)
+		return 0;
+	if (p != 0 && n >= p)
+		n = p - 1;
+	if ((p & 1) == 0)
+		return sumFactorialsModEven(n, p);
+
+	//pInv = p^-1 mod 2^64 by Newton iteration (each step doubles the correct bits)
+	uint64_t pInv = p;
+	for (int i = 0; i < 5; i++)
+		pInv *= 2 - p * pInv;
+	//Montgomery form of x is x * 2^64 mod p
+	uint64_t one = (uint64_t)(((u128)1 << 64) % p);
+
+	uint64_t k = 0, factorial = one, sum = 0;
+	for (uint64_t i = 1; i <= n; i++) {
+		k = addMod(k, one, p);
+		factorial = montMul(factorial, k, p, pInv);
+		if (factorial == 0)
+			break;
+		sum = addMod(sum, factorial, p);
+	}
+	//Leave Montgomery form
+	return montMul(sum, 1, p, pInv);
+}
+
+//Montgomery needs an odd modulus, so even p falls back to 128-bit remainders
+//p = 0 stands for 2^64, where plain unsigned arithmetic already wraps
+static uint64_t sumFactorialsModEven(uint64_t n, uint64_t p)
+{
+	uint64_t factorial = 1, sum = 0;
+	for (uint64_t i = 1; i <= n; i++) {
+		factorial = p == 0 ? factorial * i : (uint64_t)(((u128)factorial * i) % p);
+		if (factorial == 0)
+			break;
+		sum = addMod(sum, factorial, p);
+	}
+	return sum;
+}
+
+static unsigned hashKey(uint64_t n, uint64_t p)
+{
+	uint64_t h = n * 0x9E3779B97F4A7C15ull ^ (p + 0x632BE59BD9B4E019ull + (n << 6) + (n >> 2));
+	h ^= h >> 29;
+	return (unsigned)(h % HASH_BUCKETS);
+}
+
+static void unlinkEntry(cacheEntry *e)
+{
+	if (e->prev)
+		e->prev->next = e->next;
+	else
+		mostRecent = e->next;
+	if (e->next)
+		e->next->prev = e->prev;
+	else
+		leastRecent = e->prev;
+}
+
+static void pushFront(cacheEntry *e)
+{
+	e->prev = NULL;
+	e->next = mostRecent;
+	if (mostRecent)
+		mostRecent->prev = e;
+	mostRecent = e;
+	if (leastRecent == NULL)
+		leastRecent = e;
+}
+
+uint64_t cachedSumFactorialsMod(uint64_t n, uint64_t p, int *hit)
+{
+	unsigned h = hashKey(n, p);
+
+	//Look up and refresh an existing entry
+	pthread_mutex_lock(&cacheLock);
+	for (cacheEntry *e = buckets[h]; e != NULL; e = e->chain) {
+		if (e->n == n && e->p == p) {
+			unlinkEntry(e);
+			pushFront(e);
+			cacheStats.hits++;
+			uint64_t value = e->value;
+			pthread_mutex_unlock(&cacheLock);
+			*hit = 1;
+			return value;
+		}
+	}
+	cacheStats.misses++;
+	pthread_mutex_unlock(&cacheLock);
+
+	//Compute without holding the lock so other clients are not blocked
+	uint64_t value = sumFactorialsMod(n, p);
+	*hit = 0;
+
+	pthread_mutex_lock(&cacheLock);
+	//Another thread may have inserted the same key meanwhile
+	for (cacheEntry *e = buckets[h]; e != NULL; e = e->chain) {
+		if (e->n == n && e->p == p) {
+			pthread_mutex_unlock(&cacheLock);
+			return value;
+		}
+	}
+	cacheEntry *e;
+	if (cacheSize == MOD_CACHE_CAPACITY) {
+		//Evict the least recently used entry and reuse its memory
+		e = leastRecent;
+		unlinkEntry(e);
+		cacheEntry **link = &buckets[hashKey(e->n, e->p)];
+		while (*link != e)
+			link = &(*link)->chain;
+		*link = e->chain;
+	}
+	else {
+		e = (cacheEntry*)malloc(sizeof(cacheEntry));
+		cacheSize++;
+	}
+	e->n = n;
+	e->p = p;
+	e->value = value;
+	e->chain = buckets[h];
+	buckets[h] = e;
+	pushFront(e);
+	pthread_mutex_unlock(&cacheLock);
+	return value;
+}
+
+void modCacheGetStats(modCacheStats *stats)
+{
+	pthread_mutex_lock(&cacheLock);
+	*stats = cacheStats;
+	pthread_mutex_unlock(&cacheLock);
+}
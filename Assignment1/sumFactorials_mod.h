@@ -0,0 +1,25 @@
+/*
+ * Sum of factorials modulo p with a shared LRU result cache.
+ */
+#ifndef SUMFACTORIALS_MOD_H
+#define SUMFACTORIALS_MOD_H
+
+#include <stdint.h>
+
+//Most (N, p) results the cache keeps before evicting the least recently used
+#define MOD_CACHE_CAPACITY 4096
+
+typedef struct {
+	uint64_t hits;
+	uint64_t misses;
+} modCacheStats;
+
+//(1! + 2! + ... + n!) mod p in O(min(n, p)) using Montgomery multiplication; p = 0 means mod 2^64
+uint64_t sumFactorialsMod(uint64_t n, uint64_t p);
+
+//Same value, served from the process-wide cache when possible. Safe to call from any thread.
+//hit is set to 1 when the value came from the cache.
+uint64_t cachedSumFactorialsMod(uint64_t n, uint64_t p, int *hit);
+void modCacheGetStats(modCacheStats *stats);
+
+#endif
@@ -0,0 +1,575 @@
+/*
+ * Multithreaded server for SUM_PROG.
+ *
+ * The rpcgen server in sumFactorials_svc.c decodes, computes and replies to one
+ * request at a time inside svc_run. This server keeps the same registration
+ * (UDP and TCP, every version in sumFactorials.x), also accepts same-host clients
+ * of the same user on a Unix socket (see sumLocalPath), and only decodes requests on
+ * the receiving thread. Decoded requests are queued to a pool of worker threads,
+ * each of which calls the same *_svc procedures from sumFactorials_server.c with
+ * its own argument and result storage (rpcgen -M) and sends the reply itself.
+ * At most MAX_QUEUED_JOBS calls wait at once: stream readers then stop reading
+ * and UDP calls are dropped, so a client sending faster than the workers can
+ * answer cannot grow the server's memory without limit.
+ *
+ * usage: sumFactorials_server_mt [-t NUM_WORKERS] [-v]   (-v prints a line for every call)
+ */
+
+#include "sumFactorials.h"
+#include "sumFactorials_local.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <rpc/pmap_clnt.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define MAX_WORKERS 256
+#define MAX_RECORD_SIZE (16 * 1024 * 1024)
+#define LAST_FRAGMENT 0x80000000u
+//Decoded calls that may wait for a worker before receivers hold back
+#define MAX_QUEUED_JOBS 1024
+
+//A TCP or Unix socket connection shared by its reader thread and every in-flight job
+typedef struct connection {
+	int fd;
+	int refs;
+	pthread_mutex_t lock;	//Serialises replies and guards refs
+} connection;
+
+//One entry for every (version, procedure) in sumFactorials.x
+typedef struct {
+	rpcvers_t vers;
+	rpcproc_t proc;
+	xdrproc_t xdrArgument;
+	xdrproc_t xdrResult;
+	bool_t (*local)(char *, void *, struct svc_req *);
+	int (*freeResult)(SVCXPRT *, xdrproc_t, caddr_t);
+} procEntry;
+
+//A decoded request waiting for, or being served by, a worker
+typedef struct job {
+	const procEntry *entry;
+	u_int32_t xid;
+	struct svc_req req;
+	union {
+		number sumfactorial_1_arg;
+		numberList sumfactorialbatch_2_arg;
+		modNumber sumfactorialmod_4_arg;
+	} argument;
+	union {
+		long sumfactorial_1_res;
+		resultList sumfactorialbatch_2_res;
+		digitString sumfactorialexact_3_res;
+		u_quad_t sumfactorialmod_4_res;
+	} result;
+	//Where the reply goes: a UDP peer or a stream connection
+	int udpSock;
+	struct sockaddr_storage addr;
+	socklen_t addrLen;
+	connection *conn;
+	struct job *next;
+} job;
+
+static const procEntry procTable[] = {
+	{ SUM_VERS, sumFactorial, (xdrproc_t) xdr_number, (xdrproc_t) xdr_long,
+	  (bool_t (*)(char *, void *, struct svc_req *)) sumfactorial_1_svc, sum_prog_1_freeresult },
+	{ SUM_BATCH_VERS, sumFactorial, (xdrproc_t) xdr_number, (xdrproc_t) xdr_long,
+	  (bool_t (*)(char *, void *, struct svc_req *)) sumfactorial_2_svc, sum_prog_2_freeresult },
+	{ SUM_BATCH_VERS, sumFactorialBatch, (xdrproc_t) xdr_numberList, (xdrproc_t) xdr_resultList,
+	  (bool_t (*)(char *, void *, struct svc_req *)) sumfactorialbatch_2_svc, sum_prog_2_freeresult },
+	{ SUM_EXACT_VERS, sumFactorial, (xdrproc_t) xdr_number, (xdrproc_t) xdr_long,
+	  (bool_t (*)(char *, void *, struct svc_req *)) sumfactorial_3_svc, sum_prog_3_freeresult },
+	{ SUM_EXACT_VERS, sumFactorialBatch, (xdrproc_t) xdr_numberList, (xdrproc_t) xdr_resultList,
+	  (bool_t (*)(char *, void *, struct svc_req *)) sumfactorialbatch_3_svc, sum_prog_3_freeresult },
+	{ SUM_EXACT_VERS, sumFactorialExact, (xdrproc_t) xdr_number, (xdrproc_t) xdr_digitString,
+	  (bool_t (*)(char *, void *, struct svc_req *)) sumfactorialexact_3_svc, sum_prog_3_freeresult },
+	{ SUM_MOD_VERS, sumFactorial, (xdrproc_t) xdr_number, (xdrproc_t) xdr_long,
+	  (bool_t (*)(char *, void *, struct svc_req *)) sumfactorial_4_svc, sum_prog_4_freeresult },
+	{ SUM_MOD_VERS, sumFactorialBatch, (xdrproc_t) xdr_numberList, (xdrproc_t) xdr_resultList,
+	  (bool_t (*)(char *, void *, struct svc_req *)) sumfactorialbatch_4_svc, sum_prog_4_freeresult },
+	{ SUM_MOD_VERS, sumFactorialExact, (xdrproc_t) xdr_number, (xdrproc_t) xdr_digitString,
+	  (bool_t (*)(char *, void *, struct svc_req *)) sumfactorialexact_4_svc, sum_prog_4_freeresult },
+	{ SUM_MOD_VERS, sumFactorialMod, (xdrproc_t) xdr_modNumber, (xdrproc_t) xdr_u_quad_t,
+	  (bool_t (*)(char *, void *, struct svc_req *)) sumfactorialmod_4_svc, sum_prog_4_freeresult },
+};
+#define NUM_PROCS (sizeof(procTable) / sizeof(procTable[0]))
+#define LOW_VERS SUM_VERS
+#define HIGH_VERS SUM_MOD_VERS
+
+//Threads per sumFactorialExact call and per-call logging, in sumFactorials_server.c
+extern int sumExactThreads;
+extern int sumServerVerbose;
+
+//Work queue shared by the receiving threads and the workers
+static job *queueHead = NULL, *queueTail = NULL;
+static int queueLength = 0;
+static pthread_mutex_t queueLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queueNotEmpty = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t queueNotFull = PTHREAD_COND_INITIALIZER;
+
+//Function Declarations
+static int enqueueJob(job *j, int wait);
+static job *dequeueJob(void);
+static void *workerFunc(void *pArg);
+static void *udpReceiverFunc(void *pArg);
+static void *acceptFunc(void *pArg);
+static void *streamReaderFunc(void *pArg);
+static void handleCall(char *buf, u_int len, int udpSock, struct sockaddr_storage *addr, socklen_t addrLen, connection *conn);
+static void sendReply(int udpSock, struct sockaddr_storage *addr, socklen_t addrLen, connection *conn, struct rpc_msg *reply, xdrproc_t xdrResult, void *result);
+static void sendError(int udpSock, struct sockaddr_storage *addr, socklen_t addrLen, connection *conn, u_int32_t xid, enum accept_stat stat);
+static void releaseConnection(connection *conn);
+static int createSocket(int type, u_short *port);
+static int createLocalSocket(char *path, size_t len);
+
+int
+main (int argc, char **argv)
+{
+	int numCores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	int numWorkers = numCores;
+	int udpSock, tcpSock, localSock;
+	u_short udpPort, tcpPort;
+	char localPath[sizeof(((struct sockaddr_un *)0)->sun_path)];
+	pthread_t tid;
+
+	//A client that disconnects before its reply is written must not kill the server
+	signal(SIGPIPE, SIG_IGN);
+
+	//Worker count defaults to the number of online cores; calls are only logged with -v
+	sumServerVerbose = 0;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+			numWorkers = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-v") == 0)
+			sumServerVerbose = 1;
+		else {
+			fprintf (stderr, "usage: %s [-t NUM_WORKERS] [-v]\n", argv[0]);
+			exit(1);
+		}
+	}
+	if (numWorkers < 1)
+		numWorkers = 1;
+	if (numWorkers > MAX_WORKERS)
+		numWorkers = MAX_WORKERS;
+	//Every worker may be in sumFactorialExact at once, so each call gets an equal share of the cores
+	sumExactThreads = numCores / numWorkers > 1 ? numCores / numWorkers : 1;
+
+	udpSock = createSocket(SOCK_DGRAM, &udpPort);
+	tcpSock = createSocket(SOCK_STREAM, &tcpPort);
+	localSock = createLocalSocket(localPath, sizeof(localPath));
+	if (udpSock < 0 || tcpSock < 0 || localSock < 0 || listen(tcpSock, SOMAXCONN) < 0 || listen(localSock, SOMAXCONN) < 0) {
+		fprintf (stderr, "%s", "cannot create service sockets.");
+		exit(1);
+	}
+
+	//Register every version with the portmapper so clnt_create finds this server
+	for (rpcvers_t vers = LOW_VERS; vers <= HIGH_VERS; vers++) {
+		pmap_unset (SUM_PROG, vers);
+		if (!pmap_set(SUM_PROG, vers, IPPROTO_UDP, udpPort) || !pmap_set(SUM_PROG, vers, IPPROTO_TCP, tcpPort)) {
+			fprintf (stderr, "unable to register (SUM_PROG, %lu).", (unsigned long)vers);
+			exit(1);
+		}
+	}
+
+	//Fork the worker pool
+	for (int i = 0; i < numWorkers; i++)
+		pthread_create(&tid, NULL, workerFunc, NULL);
+	printf("SERVER: %d worker threads (%d per exact sum) serving udp port %u, tcp port %u and %s \n", numWorkers, sumExactThreads, udpPort, tcpPort, localPath);
+	fflush(stdout);
+
+	//Accept stream connections on their own threads and receive UDP datagrams on this one
+	pthread_create(&tid, NULL, acceptFunc, &tcpSock);
+	pthread_create(&tid, NULL, acceptFunc, &localSock);
+	udpReceiverFunc(&udpSock);
+	fprintf (stderr, "%s", "udp receiver returned");
+	exit (1);
+	/* NOTREACHED */
+}
+
+//Bind a socket of the given type to any free port and return that port
+static int createSocket(int type, u_short *port)
+{
+	struct sockaddr_in addr;
+	socklen_t len = sizeof(addr);
+	int sock = socket(AF_INET, type, 0);
+	if (sock < 0)
+		return -1;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 || getsockname(sock, (struct sockaddr *)&addr, &len) < 0) {
+		close(sock);
+		return -1;
+	}
+	*port = ntohs(addr.sin_port);
+	return sock;
+}
+
+//Bind the same-host stream socket, replacing one left by an earlier server of this user
+static int createLocalSocket(char *path, size_t len)
+{
+	struct sockaddr_un addr;
+	struct stat st;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (!sumLocalPath(addr.sun_path, sizeof(addr.sun_path), 1))
+		return -1;
+	if (lstat(addr.sun_path, &st) == 0) {
+		if (!S_ISSOCK(st.st_mode) || st.st_uid != geteuid())
+			return -1;
+		unlink(addr.sun_path);
+	}
+	int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (sock < 0)
+		return -1;
+	//Create the socket file 0600 from the start; other users reach the server over UDP and TCP
+	mode_t oldMask = umask(077);
+	int bound = bind(sock, (struct sockaddr *)&addr, sizeof(addr));
+	umask(oldMask);
+	if (bound < 0) {
+		close(sock);
+		return -1;
+	}
+	snprintf(path, len, "%s", addr.sun_path);
+	return sock;
+}
+
+static void *udpReceiverFunc(void *pArg)
+{
+	int sock = *((int*)pArg);
+	char buf[UDPMSGSIZE];
+	struct sockaddr_storage addr;
+	socklen_t addrLen;
+
+	while (1) {
+		addrLen = sizeof(addr);
+		ssize_t len = recvfrom(sock, buf, sizeof(buf), 0, (struct sockaddr *)&addr, &addrLen);
+		if (len < 0) {
+			if (errno == EINTR)
+				continue;
+			perror("recvfrom");
+			return NULL;
+		}
+		handleCall(buf, (u_int)len, sock, &addr, addrLen, NULL);
+	}
+}
+
+static void *acceptFunc(void *pArg)
+{
+	int sock = *((int*)pArg);
+	pthread_t tid;
+
+	while (1) {
+		int fd = accept(sock, NULL, NULL);
+		if (fd < 0) {
+			if (errno == EINTR || errno == ECONNABORTED)
+				continue;
+			perror("accept");
+			return NULL;
+		}
+		connection *conn = (connection*)malloc(sizeof(connection));
+		conn->fd = fd;
+		conn->refs = 1;
+		pthread_mutex_init(&conn->lock, NULL);
+		pthread_create(&tid, NULL, streamReaderFunc, conn);
+		pthread_detach(tid);
+	}
+}
+
+//Read exactly len bytes, returning 0 on EOF or error
+static int readFully(int fd, char *buf, size_t len)
+{
+	while (len > 0) {
+		ssize_t n = read(fd, buf, len);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return 0;
+		buf += n;
+		len -= n;
+	}
+	return 1;
+}
+
+//Reassemble record-marked calls from one stream connection and queue each of them
+static void *streamReaderFunc(void *pArg)
+{
+	connection *conn = (connection*)pArg;
+	size_t capacity = 4096;
+	char *buf = (char*)malloc(capacity);
+	u_int32_t header;
+
+	if (buf == NULL)
+		goto closed;
+
+	while (1) {
+		size_t len = 0;
+		int last = 0;
+		while (!last) {
+			if (!readFully(conn->fd, (char *)&header, sizeof(header)))
+				goto closed;
+			header = ntohl(header);
+			last = (header & LAST_FRAGMENT) != 0;
+			size_t fragLen = header & ~LAST_FRAGMENT;
+			if (len + fragLen > MAX_RECORD_SIZE)
+				goto closed;
+			if (len + fragLen > capacity) {
+				while (len + fragLen > capacity)
+					capacity *= 2;
+				char *grown = (char*)realloc(buf, capacity);
+				if (grown == NULL)
+					goto closed;
+				buf = grown;
+			}
+			if (!readFully(conn->fd, buf + len, fragLen))
+				goto closed;
+			len += fragLen;
+		}
+		handleCall(buf, (u_int)len, -1, NULL, 0, conn);
+	}
+
+closed:
+	//Stop reading; in-flight jobs keep the connection until their replies are written
+	shutdown(conn->fd, SHUT_RD);
+	free(buf);
+	releaseConnection(conn);
+	return NULL;
+}
+
+static void releaseConnection(connection *conn)
+{
+	pthread_mutex_lock(&conn->lock);
+	int refs = --conn->refs;
+	pthread_mutex_unlock(&conn->lock);
+	if (refs == 0) {
+		close(conn->fd);
+		pthread_mutex_destroy(&conn->lock);
+		free(conn);
+	}
+}
+
+//Decode the call header and arguments, then hand the request to the worker pool
+static void handleCall(char *buf, u_int len, int udpSock, struct sockaddr_storage *addr, socklen_t addrLen, connection *conn)
+{
+	XDR xdrs;
+	struct rpc_msg call;
+	char credArea[2 * MAX_AUTH_BYTES];
+	const procEntry *entry = NULL;
+	int versFound = 0;
+
+	memset(&call, 0, sizeof(call));
+	call.rm_call.cb_cred.oa_base = credArea;
+	call.rm_call.cb_verf.oa_base = credArea + MAX_AUTH_BYTES;
+	xdrmem_create(&xdrs, buf, len, XDR_DECODE);
+	if (!xdr_callmsg(&xdrs, &call) || call.rm_direction != CALL) {
+		xdr_destroy(&xdrs);
+		return;
+	}
+	if (call.rm_call.cb_rpcvers != RPC_MSG_VERSION || call.rm_call.cb_prog != SUM_PROG) {
+		sendError(udpSock, addr, addrLen, conn, call.rm_xid, PROG_UNAVAIL);
+		xdr_destroy(&xdrs);
+		return;
+	}
+
+	//Find the procedure to run
+	for (size_t i = 0; i < NUM_PROCS; i++) {
+		if (procTable[i].vers == call.rm_call.cb_vers) {
+			versFound = 1;
+			if (procTable[i].proc == call.rm_call.cb_proc)
+				entry = &procTable[i];
+		}
+	}
+	if (!versFound) {
+		sendError(udpSock, addr, addrLen, conn, call.rm_xid, PROG_MISMATCH);
+		xdr_destroy(&xdrs);
+		return;
+	}
+	if (call.rm_call.cb_proc == NULLPROC) {
+		struct rpc_msg reply;
+		memset(&reply, 0, sizeof(reply));
+		reply.rm_xid = call.rm_xid;
+		reply.rm_direction = REPLY;
+		reply.rm_reply.rp_stat = MSG_ACCEPTED;
+		reply.acpted_rply.ar_verf = _null_auth;
+		reply.acpted_rply.ar_stat = SUCCESS;
+		sendReply(udpSock, addr, addrLen, conn, &reply, (xdrproc_t) xdr_void, NULL);
+		xdr_destroy(&xdrs);
+		return;
+	}
+	if (entry == NULL) {
+		sendError(udpSock, addr, addrLen, conn, call.rm_xid, PROC_UNAVAIL);
+		xdr_destroy(&xdrs);
+		return;
+	}
+
+	//Each job owns its own argument and result storage
+	job *j = (job*)calloc(1, sizeof(job));
+	j->entry = entry;
+	j->xid = call.rm_xid;
+	j->req.rq_prog = SUM_PROG;
+	j->req.rq_vers = call.rm_call.cb_vers;
+	j->req.rq_proc = call.rm_call.cb_proc;
+	if (!(*entry->xdrArgument)(&xdrs, (caddr_t) &j->argument)) {
+		xdr_free(entry->xdrArgument, (caddr_t) &j->argument);
+		free(j);
+		sendError(udpSock, addr, addrLen, conn, call.rm_xid, GARBAGE_ARGS);
+		xdr_destroy(&xdrs);
+		return;
+	}
+	xdr_destroy(&xdrs);
+
+	j->udpSock = udpSock;
+	if (addr != NULL) {
+		memcpy(&j->addr, addr, addrLen);
+		j->addrLen = addrLen;
+	}
+	j->conn = conn;
+	if (conn != NULL) {
+		pthread_mutex_lock(&conn->lock);
+		conn->refs++;
+		pthread_mutex_unlock(&conn->lock);
+	}
+	//A stream reader waits for room, which holds its client back through flow control.
+	//A UDP call is dropped when the queue is full and the client retransmits it.
+	if (!enqueueJob(j, conn != NULL)) {
+		xdr_free(entry->xdrArgument, (caddr_t) &j->argument);
+		free(j);
+	}
+}
+
+//Add a job unless the queue is full and wait is 0. Returns 1 when the job was queued.
+static int enqueueJob(job *j, int wait)
+{
+	pthread_mutex_lock(&queueLock);
+	while (queueLength == MAX_QUEUED_JOBS) {
+		if (!wait) {
+			pthread_mutex_unlock(&queueLock);
+			return 0;
+		}
+		pthread_cond_wait(&queueNotFull, &queueLock);
+	}
+	if (queueTail == NULL)
+		queueHead = j;
+	else
+		queueTail->next = j;
+	queueTail = j;
+	queueLength++;
+	pthread_cond_signal(&queueNotEmpty);
+	pthread_mutex_unlock(&queueLock);
+	return 1;
+}
+
+static job *dequeueJob(void)
+{
+	pthread_mutex_lock(&queueLock);
+	while (queueHead == NULL)
+		pthread_cond_wait(&queueNotEmpty, &queueLock);
+	job *j = queueHead;
+	queueHead = j->next;
+	if (queueHead == NULL)
+		queueTail = NULL;
+	queueLength--;
+	pthread_cond_signal(&queueNotFull);
+	pthread_mutex_unlock(&queueLock);
+	return j;
+}
+
+//Run queued requests and reply to each client directly from the worker
+static void *workerFunc(void *pArg)
+{
+	while (1) {
+		job *j = dequeueJob();
+		const procEntry *entry = j->entry;
+
+		if ((*entry->local)((char *)&j->argument, (void *)&j->result, &j->req)) {
+			struct rpc_msg reply;
+			memset(&reply, 0, sizeof(reply));
+			reply.rm_xid = j->xid;
+			reply.rm_direction = REPLY;
+			reply.rm_reply.rp_stat = MSG_ACCEPTED;
+			reply.acpted_rply.ar_verf = _null_auth;
+			reply.acpted_rply.ar_stat = SUCCESS;
+			sendReply(j->udpSock, &j->addr, j->addrLen, j->conn, &reply, entry->xdrResult, &j->result);
+			(*entry->freeResult)(NULL, entry->xdrResult, (caddr_t) &j->result);
+		}
+		else {
+			sendError(j->udpSock, &j->addr, j->addrLen, j->conn, j->xid, SYSTEM_ERR);
+		}
+
+		xdr_free(entry->xdrArgument, (caddr_t) &j->argument);
+		if (j->conn != NULL)
+			releaseConnection(j->conn);
+		free(j);
+	}
+	return NULL;
+}
+
+//Encode a reply and send it as a datagram or as one stream record
+static void sendReply(int udpSock, struct sockaddr_storage *addr, socklen_t addrLen, connection *conn, struct rpc_msg *reply, xdrproc_t xdrResult, void *result)
+{
+	XDR xdrs;
+	//Only successful replies carry results; errors may use the same union for ar_vers
+	if (reply->acpted_rply.ar_stat == SUCCESS) {
+		reply->acpted_rply.ar_results.where = (caddr_t) result;
+		reply->acpted_rply.ar_results.proc = xdrResult;
+	}
+
+	//Leave room for the record mark in front of stream replies
+	u_int size = 4 + xdr_sizeof((xdrproc_t) xdr_replymsg, reply);
+	char *buf = (char*)malloc(size);
+	xdrmem_create(&xdrs, buf + 4, size - 4, XDR_ENCODE);
+	if (!xdr_replymsg(&xdrs, reply)) {
+		fprintf(stderr, "unable to encode reply\n");
+		xdr_destroy(&xdrs);
+		free(buf);
+		return;
+	}
+	u_int len = XDR_GETPOS(&xdrs);
+	xdr_destroy(&xdrs);
+
+	if (conn == NULL) {
+		sendto(udpSock, buf + 4, len, 0, (struct sockaddr *)addr, addrLen);
+	}
+	else {
+		u_int32_t header = htonl(LAST_FRAGMENT | len);
+		memcpy(buf, &header, 4);
+		len += 4;
+		pthread_mutex_lock(&conn->lock);
+		for (char *p = buf; len > 0; ) {
+			ssize_t n = send(conn->fd, p, len, MSG_NOSIGNAL);
+			if (n < 0 && errno == EINTR)
+				continue;
+			if (n <= 0) {
+				//EPIPE or any other error: drop this connection only. Its reader sees
+				//EOF and the last job to finish closes the descriptor.
+				shutdown(conn->fd, SHUT_RDWR);
+				break;
+			}
+			p += n;
+			len -= n;
+		}
+		pthread_mutex_unlock(&conn->lock);
+	}
+	free(buf);
+}
+
+static void sendError(int udpSock, struct sockaddr_storage *addr, socklen_t addrLen, connection *conn, u_int32_t xid, enum accept_stat stat)
+{
+	struct rpc_msg reply;
+	memset(&reply, 0, sizeof(reply));
+	reply.rm_xid = xid;
+	reply.rm_direction = REPLY;
+	reply.rm_reply.rp_stat = MSG_ACCEPTED;
+	reply.acpted_rply.ar_verf = _null_auth;
+	reply.acpted_rply.ar_stat = stat;
+	if (stat == PROG_MISMATCH) {
+		reply.acpted_rply.ar_vers.low = LOW_VERS;
+		reply.acpted_rply.ar_vers.high = HIGH_VERS;
+	}
+	sendReply(udpSock, addr, addrLen, conn, &reply, (xdrproc_t) xdr_void, NULL);
+}
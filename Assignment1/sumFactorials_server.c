@@ -1,28 +1,187 @@
 
 #include "sumFactorials.h"
+#include "sumFactorials_bignum.h"
+#include "sumFactorials_mod.h"
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
 
-long *
-sumfactorial_1_svc(number *argp, struct svc_req *rqstp)
+//Largest N sumFactorialExact accepts (about 1.1 million digits)
+#define MAX_EXACT_N 200000
+
+//Threads one sumFactorialExact call uses; 0 means one per core. The stock server runs
+//one call at a time, while the multithreaded server shares the cores among its workers.
+int sumExactThreads = 0;
+
+//1 to print a line for every call. The multithreaded server turns this off unless asked,
+//since its workers would otherwise all queue on the stdout lock.
+int sumServerVerbose = 1;
+
+long calcSumFactorial(int n);
+
+bool_t
+sumfactorial_1_svc(number *argp, long *result, struct svc_req *rqstp)
 {
-	static long  result;
-    long total=0;
     //Receive value of N from client 
-	printf("SERVER: sumFactorial(%d) was called \n",argp->x);
-	
-    //Iterate through each Number
-    for (int i=1; i<=argp->x; i++){
-        printf("Calculating factorial for %d \n",i);
-        long factorial=1;
-        //Calculate Factorial   
-        for (int j=1; j<=i; j++){
-            factorial*=j;        
-        }
-        //Print factorial just calculated
-        printf("Factorial for %d is %ld \n", i,factorial);
-        //Add to total
+	if (sumServerVerbose)
+		printf("SERVER: sumFactorial(%d) was called \n",argp->x);
+
+    //Same O(N) running factorial as the batch procedure, so the two only differ in round trips
+    //Store result in the caller's per-request storage to send back to client process
+    *result = calcSumFactorial(argp->x);
+	return TRUE;
+}
+
+bool_t
+sumfactorial_2_svc(number *argp, long *result, struct svc_req *rqstp)
+{
+    //Version 2 keeps the single N procedure so one client handle serves both calls
+    return sumfactorial_1_svc(argp, result, rqstp);
+}
+
+bool_t
+sumfactorialbatch_2_svc(numberList *argp, resultList *result, struct svc_req *rqstp)
+{
+	if (sumServerVerbose)
+		printf("SERVER: sumFactorialBatch(%u values) was called \n",argp->numberList_len);
+
+    //Allocate one result for every N received from the client
+    //The array is released by sum_prog_2_freeresult once the reply has been sent
+    result->resultList_len = argp->numberList_len;
+    result->resultList_val = (quad_t*)malloc(argp->numberList_len * sizeof(quad_t));
+    if (result->resultList_val == NULL && argp->numberList_len > 0){
+        result->resultList_len = 0;
+        return FALSE;
+    }
+
+    //Calculate the sum of factorials for each N in the batch
+    for (u_int i=0; i<argp->numberList_len; i++){
+        result->resultList_val[i] = calcSumFactorial(argp->numberList_val[i]);
+    }
+    //Send results back to client process in the same order as received
+	return TRUE;
+}
+
+bool_t
+sumfactorial_3_svc(number *argp, long *result, struct svc_req *rqstp)
+{
+    return sumfactorial_1_svc(argp, result, rqstp);
+}
+
+bool_t
+sumfactorialbatch_3_svc(numberList *argp, resultList *result, struct svc_req *rqstp)
+{
+    return sumfactorialbatch_2_svc(argp, result, rqstp);
+}
+
+bool_t
+sumfactorialexact_3_svc(number *argp, digitString *result, struct svc_req *rqstp)
+{
+	if (sumServerVerbose)
+		printf("SERVER: sumFactorialExact(%d) was called \n",argp->x);
+
+    //An empty string tells the client N was out of range
+    if (argp->x < 0 || argp->x > MAX_EXACT_N){
+        *result = strdup("");
+        return TRUE;
+    }
+
+    //Compute the exact value with this call's share of the cores and send back its decimal digits
+    int numThreads = sumExactThreads > 0 ? sumExactThreads : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    bignum total;
+    bignumSumFactorials(argp->x, numThreads, &total);
+    *result = bignumToString(&total);
+    bignumFree(&total);
+	return TRUE;
+}
+
+bool_t
+sumfactorial_4_svc(number *argp, long *result, struct svc_req *rqstp)
+{
+    return sumfactorial_1_svc(argp, result, rqstp);
+}
+
+bool_t
+sumfactorialbatch_4_svc(numberList *argp, resultList *result, struct svc_req *rqstp)
+{
+    return sumfactorialbatch_2_svc(argp, result, rqstp);
+}
+
+bool_t
+sumfactorialexact_4_svc(number *argp, digitString *result, struct svc_req *rqstp)
+{
+    return sumfactorialexact_3_svc(argp, result, rqstp);
+}
+
+bool_t
+sumfactorialmod_4_svc(modNumber *argp, u_quad_t *result, struct svc_req *rqstp)
+{
+    struct timespec start, end;
+    modCacheStats stats;
+    int hit;
+
+    //Reject N the server cannot finish in reasonable time; a modulus of 0 stands for 2^64
+    if (argp->x < 0 || argp->x > MAX_MOD_N){
+        if (sumServerVerbose)
+            printf("SERVER: sumFactorialMod(%lld, %llu) rejected, N must be between 0 and %d \n",
+                   (long long)argp->x, (unsigned long long)argp->p, MAX_MOD_N);
+        *result = MOD_OUT_OF_RANGE;
+        return TRUE;
+    }
+
+    //Results are shared by every client of this server process
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    *result = cachedSumFactorialsMod((uint64_t)argp->x, argp->p, &hit);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    //Report the latency of this call and the cache hit rate so far
+    if (!sumServerVerbose)
+        return TRUE;
+    modCacheGetStats(&stats);
+    printf("SERVER: sumFactorialMod(%lld, %llu) = %llu, cache %s in %.1f us, hit rate %.1f%% (%llu/%llu) \n",
+           (long long)argp->x, (unsigned long long)argp->p, (unsigned long long)*result, hit ? "hit" : "miss",
+           ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / 1e3,
+           100.0 * stats.hits / (stats.hits + stats.misses),
+           (unsigned long long)stats.hits, (unsigned long long)(stats.hits + stats.misses));
+	return TRUE;
+}
+
+//Release any memory the XDR encoding of a result allocated once it has been sent
+int
+sum_prog_1_freeresult (SVCXPRT *transp, xdrproc_t xdr_result, caddr_t result)
+{
+	xdr_free (xdr_result, result);
+	return 1;
+}
+
+int
+sum_prog_2_freeresult (SVCXPRT *transp, xdrproc_t xdr_result, caddr_t result)
+{
+	xdr_free (xdr_result, result);
+	return 1;
+}
+
+int
+sum_prog_3_freeresult (SVCXPRT *transp, xdrproc_t xdr_result, caddr_t result)
+{
+	xdr_free (xdr_result, result);
+	return 1;
+}
+
+int
+sum_prog_4_freeresult (SVCXPRT *transp, xdrproc_t xdr_result, caddr_t result)
+{
+	xdr_free (xdr_result, result);
+	return 1;
+}
+
+//Sum of factorials 1! + 2! + ... + n! keeping a running factorial so each N is O(N)
+long calcSumFactorial(int n){
+    long total=0;
+    long factorial=1;
+    for (int i=1; i<=n; i++){
+        factorial*=i;
         total+=factorial;
     }
-    //Send result back to client process
-    result = total;
-	return &result;
+    return total;
 }
@@ -22,9 +22,183 @@ sum_prog_1(struct svc_req *rqstp, register SVCXPRT *transp)
 	union {
 		number sumfactorial_1_arg;
 	} argument;
-	char *result;
+	union {
+		long sumfactorial_1_res;
+	} result;
+	bool_t retval;
+	xdrproc_t _xdr_argument, _xdr_result;
+	bool_t (*local)(char *, void *, struct svc_req *);
+
+	switch (rqstp->rq_proc) {
+	case NULLPROC:
+		(void) svc_sendreply (transp, (xdrproc_t) xdr_void, (char *)NULL);
+		return;
+
+	case sumFactorial:
+		_xdr_argument = (xdrproc_t) xdr_number;
+		_xdr_result = (xdrproc_t) xdr_long;
+		local = (bool_t (*) (char *, void *,  struct svc_req *))sumfactorial_1_svc;
+		break;
+
+	default:
+		svcerr_noproc (transp);
+		return;
+	}
+	memset ((char *)&argument, 0, sizeof (argument));
+	if (!svc_getargs (transp, (xdrproc_t) _xdr_argument, (caddr_t) &argument)) {
+		svcerr_decode (transp);
+		return;
+	}
+	retval = (bool_t) (*local)((char *)&argument, (void *)&result, rqstp);
+	if (retval > 0 && !svc_sendreply(transp, (xdrproc_t) _xdr_result, (char *)&result)) {
+		svcerr_systemerr (transp);
+	}
+	if (!svc_freeargs (transp, (xdrproc_t) _xdr_argument, (caddr_t) &argument)) {
+		fprintf (stderr, "%s", "unable to free arguments");
+		exit (1);
+	}
+	if (!sum_prog_1_freeresult (transp, _xdr_result, (caddr_t) &result))
+		fprintf (stderr, "%s", "unable to free results");
+
+	return;
+}
+
+static void
+sum_prog_2(struct svc_req *rqstp, register SVCXPRT *transp)
+{
+	union {
+		number sumfactorial_2_arg;
+		numberList sumfactorialbatch_2_arg;
+	} argument;
+	union {
+		long sumfactorial_2_res;
+		resultList sumfactorialbatch_2_res;
+	} result;
+	bool_t retval;
+	xdrproc_t _xdr_argument, _xdr_result;
+	bool_t (*local)(char *, void *, struct svc_req *);
+
+	switch (rqstp->rq_proc) {
+	case NULLPROC:
+		(void) svc_sendreply (transp, (xdrproc_t) xdr_void, (char *)NULL);
+		return;
+
+	case sumFactorial:
+		_xdr_argument = (xdrproc_t) xdr_number;
+		_xdr_result = (xdrproc_t) xdr_long;
+		local = (bool_t (*) (char *, void *,  struct svc_req *))sumfactorial_2_svc;
+		break;
+
+	case sumFactorialBatch:
+		_xdr_argument = (xdrproc_t) xdr_numberList;
+		_xdr_result = (xdrproc_t) xdr_resultList;
+		local = (bool_t (*) (char *, void *,  struct svc_req *))sumfactorialbatch_2_svc;
+		break;
+
+	default:
+		svcerr_noproc (transp);
+		return;
+	}
+	memset ((char *)&argument, 0, sizeof (argument));
+	if (!svc_getargs (transp, (xdrproc_t) _xdr_argument, (caddr_t) &argument)) {
+		svcerr_decode (transp);
+		return;
+	}
+	retval = (bool_t) (*local)((char *)&argument, (void *)&result, rqstp);
+	if (retval > 0 && !svc_sendreply(transp, (xdrproc_t) _xdr_result, (char *)&result)) {
+		svcerr_systemerr (transp);
+	}
+	if (!svc_freeargs (transp, (xdrproc_t) _xdr_argument, (caddr_t) &argument)) {
+		fprintf (stderr, "%s", "unable to free arguments");
+		exit (1);
+	}
+	if (!sum_prog_2_freeresult (transp, _xdr_result, (caddr_t) &result))
+		fprintf (stderr, "%s", "unable to free results");
+
+	return;
+}
+
+static void
+sum_prog_3(struct svc_req *rqstp, register SVCXPRT *transp)
+{
+	union {
+		number sumfactorial_3_arg;
+		numberList sumfactorialbatch_3_arg;
+		number sumfactorialexact_3_arg;
+	} argument;
+	union {
+		long sumfactorial_3_res;
+		resultList sumfactorialbatch_3_res;
+		digitString sumfactorialexact_3_res;
+	} result;
+	bool_t retval;
+	xdrproc_t _xdr_argument, _xdr_result;
+	bool_t (*local)(char *, void *, struct svc_req *);
+
+	switch (rqstp->rq_proc) {
+	case NULLPROC:
+		(void) svc_sendreply (transp, (xdrproc_t) xdr_void, (char *)NULL);
+		return;
+
+	case sumFactorial:
+		_xdr_argument = (xdrproc_t) xdr_number;
+		_xdr_result = (xdrproc_t) xdr_long;
+		local = (bool_t (*) (char *, void *,  struct svc_req *))sumfactorial_3_svc;
+		break;
+
+	case sumFactorialBatch:
+		_xdr_argument = (xdrproc_t) xdr_numberList;
+		_xdr_result = (xdrproc_t) xdr_resultList;
+		local = (bool_t (*) (char *, void *,  struct svc_req *))sumfactorialbatch_3_svc;
+		break;
+
+	case sumFactorialExact:
+		_xdr_argument = (xdrproc_t) xdr_number;
+		_xdr_result = (xdrproc_t) xdr_digitString;
+		local = (bool_t (*) (char *, void *,  struct svc_req *))sumfactorialexact_3_svc;
+		break;
+
+	default:
+		svcerr_noproc (transp);
+		return;
+	}
+	memset ((char *)&argument, 0, sizeof (argument));
+	if (!svc_getargs (transp, (xdrproc_t) _xdr_argument, (caddr_t) &argument)) {
+		svcerr_decode (transp);
+		return;
+	}
+	retval = (bool_t) (*local)((char *)&argument, (void *)&result, rqstp);
+	if (retval > 0 && !svc_sendreply(transp, (xdrproc_t) _xdr_result, (char *)&result)) {
+		svcerr_systemerr (transp);
+	}
+	if (!svc_freeargs (transp, (xdrproc_t) _xdr_argument, (caddr_t) &argument)) {
+		fprintf (stderr, "%s", "unable to free arguments");
+		exit (1);
+	}
+	if (!sum_prog_3_freeresult (transp, _xdr_result, (caddr_t) &result))
+		fprintf (stderr, "%s", "unable to free results");
+
+	return;
+}
+
+static void
+sum_prog_4(struct svc_req *rqstp, register SVCXPRT *transp)
+{
+	union {
+		number sumfactorial_4_arg;
+		numberList sumfactorialbatch_4_arg;
+		number sumfactorialexact_4_arg;
+		modNumber sumfactorialmod_4_arg;
+	} argument;
+	union {
+		long sumfactorial_4_res;
+		resultList sumfactorialbatch_4_res;
+		digitString sumfactorialexact_4_res;
+		u_quad_t sumfactorialmod_4_res;
+	} result;
+	bool_t retval;
 	xdrproc_t _xdr_argument, _xdr_result;
-	char *(*local)(char *, struct svc_req *);
+	bool_t (*local)(char *, void *, struct svc_req *);
 
 	switch (rqstp->rq_proc) {
 	case NULLPROC:
@@ -34,7 +208,25 @@ sum_prog_1(struct svc_req *rqstp, register SVCXPRT *transp)
 	case sumFactorial:
 		_xdr_argument = (xdrproc_t) xdr_number;
 		_xdr_result = (xdrproc_t) xdr_long;
-		local = (char *(*)(char *, struct svc_req *)) sumfactorial_1_svc;
+		local = (bool_t (*) (char *, void *,  struct svc_req *))sumfactorial_4_svc;
+		break;
+
+	case sumFactorialBatch:
+		_xdr_argument = (xdrproc_t) xdr_numberList;
+		_xdr_result = (xdrproc_t) xdr_resultList;
+		local = (bool_t (*) (char *, void *,  struct svc_req *))sumfactorialbatch_4_svc;
+		break;
+
+	case sumFactorialExact:
+		_xdr_argument = (xdrproc_t) xdr_number;
+		_xdr_result = (xdrproc_t) xdr_digitString;
+		local = (bool_t (*) (char *, void *,  struct svc_req *))sumfactorialexact_4_svc;
+		break;
+
+	case sumFactorialMod:
+		_xdr_argument = (xdrproc_t) xdr_modNumber;
+		_xdr_result = (xdrproc_t) xdr_u_quad_t;
+		local = (bool_t (*) (char *, void *,  struct svc_req *))sumfactorialmod_4_svc;
 		break;
 
 	default:
@@ -46,14 +238,17 @@ sum_prog_1(struct svc_req *rqstp, register SVCXPRT *transp)
 		svcerr_decode (transp);
 		return;
 	}
-	result = (*local)((char *)&argument, rqstp);
-	if (result != NULL && !svc_sendreply(transp, (xdrproc_t) _xdr_result, result)) {
+	retval = (bool_t) (*local)((char *)&argument, (void *)&result, rqstp);
+	if (retval > 0 && !svc_sendreply(transp, (xdrproc_t) _xdr_result, (char *)&result)) {
 		svcerr_systemerr (transp);
 	}
 	if (!svc_freeargs (transp, (xdrproc_t) _xdr_argument, (caddr_t) &argument)) {
 		fprintf (stderr, "%s", "unable to free arguments");
 		exit (1);
 	}
+	if (!sum_prog_4_freeresult (transp, _xdr_result, (caddr_t) &result))
+		fprintf (stderr, "%s", "unable to free results");
+
 	return;
 }
 
@@ -63,6 +258,9 @@ main (int argc, char **argv)
 	register SVCXPRT *transp;
 
 	pmap_unset (SUM_PROG, SUM_VERS);
+	pmap_unset (SUM_PROG, SUM_BATCH_VERS);
+	pmap_unset (SUM_PROG, SUM_EXACT_VERS);
+	pmap_unset (SUM_PROG, SUM_MOD_VERS);
 
 	transp = svcudp_create(RPC_ANYSOCK);
 	if (transp == NULL) {
@@ -73,6 +271,18 @@ main (int argc, char **argv)
 		fprintf (stderr, "%s", "unable to register (SUM_PROG, SUM_VERS, udp).");
 		exit(1);
 	}
+	if (!svc_register(transp, SUM_PROG, SUM_BATCH_VERS, sum_prog_2, IPPROTO_UDP)) {
+		fprintf (stderr, "%s", "unable to register (SUM_PROG, SUM_BATCH_VERS, udp).");
+		exit(1);
+	}
+	if (!svc_register(transp, SUM_PROG, SUM_EXACT_VERS, sum_prog_3, IPPROTO_UDP)) {
+		fprintf (stderr, "%s", "unable to register (SUM_PROG, SUM_EXACT_VERS, udp).");
+		exit(1);
+	}
+	if (!svc_register(transp, SUM_PROG, SUM_MOD_VERS, sum_prog_4, IPPROTO_UDP)) {
+		fprintf (stderr, "%s", "unable to register (SUM_PROG, SUM_MOD_VERS, udp).");
+		exit(1);
+	}
 
 	transp = svctcp_create(RPC_ANYSOCK, 0, 0);
 	if (transp == NULL) {
@@ -83,6 +293,18 @@ main (int argc, char **argv)
 		fprintf (stderr, "%s", "unable to register (SUM_PROG, SUM_VERS, tcp).");
 		exit(1);
 	}
+	if (!svc_register(transp, SUM_PROG, SUM_BATCH_VERS, sum_prog_2, IPPROTO_TCP)) {
+		fprintf (stderr, "%s", "unable to register (SUM_PROG, SUM_BATCH_VERS, tcp).");
+		exit(1);
+	}
+	if (!svc_register(transp, SUM_PROG, SUM_EXACT_VERS, sum_prog_3, IPPROTO_TCP)) {
+		fprintf (stderr, "%s", "unable to register (SUM_PROG, SUM_EXACT_VERS, tcp).");
+		exit(1);
+	}
+	if (!svc_register(transp, SUM_PROG, SUM_MOD_VERS, sum_prog_4, IPPROTO_TCP)) {
+		fprintf (stderr, "%s", "unable to register (SUM_PROG, SUM_MOD_VERS, tcp).");
+		exit(1);
+	}
 
 	svc_run ();
 	fprintf (stderr, "%s", "svc_run returned");
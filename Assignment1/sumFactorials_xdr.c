@@ -14,3 +14,47 @@ xdr_number (XDR *xdrs, number *objp)
 		 return FALSE;
 	return TRUE;
 }
+
+bool_t
+xdr_numberList (XDR *xdrs, numberList *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_array (xdrs, (char **)&objp->numberList_val, (u_int *) &objp->numberList_len, ~0,
+		sizeof (int), (xdrproc_t) xdr_int))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_resultList (XDR *xdrs, resultList *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_array (xdrs, (char **)&objp->resultList_val, (u_int *) &objp->resultList_len, ~0,
+		sizeof (quad_t), (xdrproc_t) xdr_quad_t))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_digitString (XDR *xdrs, digitString *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_string (xdrs, objp, ~0))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_modNumber (XDR *xdrs, modNumber *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_quad_t (xdrs, &objp->x))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->p))
+		 return FALSE;
+	return TRUE;
+}
@@ -0,0 +1,327 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+
+//Runs each serial/parallel pair of lab programs over problem sizes and worker counts
+//without any typing, and prints wall time, speedup, efficiency and a fitted Amdahl
+//serial fraction as CSV. Every program is timed the same way from the outside
+//(CLOCK_MONOTONIC around the whole process, including MPI start-up), whatever clock
+//it uses for its own report. Program output goes to /dev/null, and files the
+//programs write land in the current directory.
+//
+//The programs are looked up in one directory (-d), built for example with
+//  gcc -O2 -o bin/primes_serial_with_timer Week3/primes_serial_with_timer.c Week3/primes_sieve.c Week3/primes_bitset.c Week3/primes_primality.c Week3/primes_writer.c Week3/primes_count.c -lm -lpthread
+//  gcc -O2 -o bin/primes_parallel_with_timer Week3/primes_parallel_with_timer.c Week3/primes_sieve.c Week3/primes_bitset.c Week3/primes_primality.c Week3/primes_writer.c Week3/primes_count.c -lm -lpthread
+//  mpicc -O2 -o bin/q2e Week6/q2e.c Week6/primes_mpiio.c Week3/primes_sieve.c Week3/primes_bitset.c Week3/primes_primality.c Week3/primes_writer.c -lm -lpthread
+//  gcc -O2 -o bin/q5_serial Week5/q5_serial.c -lm
+//  mpicc -O2 -o bin/q5_mpi Week5/q5_mpi.c -lm
+//  mpicc -O3 -march=native -o bin/q5_hybrid Week5/q5_hybrid.c Week5/pi_kernel.c -lm -lpthread
+//  gcc -O2 -o bin/q1_timer Week11/q1_timer.c Week11/sort_merge.c Week11/sort_parallel.c Week11/sort_radix.c -lpthread
+//  mpicc -O2 -o bin/q2_timer Week11/q2_timer.c Week11/sort_merge.c Week11/sort_radix.c Week11/sort_kway.c Week11/sort_sample.c Week11/sort_mpiio.c -lm -lpthread
+
+#define MAX_LIST 32
+#define MAX_ARGS 32
+#define MAX_SERIAL_TIMES 64
+
+//A program and its arguments. {p} is replaced by the worker count and {n} by the
+//problem size. Programs that prompt for the size get it typed on stdin.
+typedef struct {
+    const char *args;
+    int sizeOnStdin;
+    int useMPI;     //started through the MPI launcher with {p} processes
+} command;
+
+typedef struct {
+    const char *name;
+    command serial;
+    command parallel;
+    long long sizes[MAX_LIST];  //default problem sizes, ending in 0
+} benchmark;
+
+static const benchmark benchmarks[] = {
+    {"primes-threads", {"primes_serial_with_timer -m sieve", 1, 0}, {"primes_parallel_with_timer -m sieve -t {p}", 1, 0},
+     {10000000LL, 100000000LL}},
+    {"primes-mpi", {"primes_serial_with_timer -m sieve", 1, 0}, {"q2e -m sieve -o mpiio", 1, 1},
+     {10000000LL, 100000000LL}},
+    {"pi-mpi", {"q5_serial {n}", 0, 0}, {"q5_mpi", 1, 1},
+     {10000000LL, 100000000LL}},
+    {"pi-hybrid", {"q5_serial {n}", 0, 0}, {"q5_hybrid -t 1", 1, 1},
+     {10000000LL, 100000000LL}},
+    {"mergesort-mpi", {"q1_timer {n}", 0, 0}, {"q2_timer -m tree {n}", 0, 1},
+     {1000000LL, 10000000LL}},
+    {"samplesort-mpi", {"q1_timer {n}", 0, 0}, {"q2_timer -m sample {n}", 0, 1},
+     {1000000LL, 10000000LL}},
+    {"mergesort-threads", {"q1_timer {n}", 0, 0}, {"q1_timer -t {p} {n}", 0, 0},
+     {10000000LL, 100000000LL}},
+    {"radixsort-threads", {"q1_timer -a radix {n}", 0, 0}, {"q1_timer -a radix -t {p} {n}", 0, 0},
+     {10000000LL, 100000000LL}},
+};
+#define NUM_BENCHMARKS (int)(sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+//Serial times already measured, so benchmarks sharing a serial program only run it once
+typedef struct {
+    const char *args;
+    long long size;
+    double seconds;
+} serialTime;
+
+static serialTime serialTimes[MAX_SERIAL_TIMES];
+static int numSerialTimes = 0;
+
+//Function Declarations
+int parseList(const char *text, long long *values);
+double runCommand(const command *c, const char *binDir, const char *launcher, int workers, long long size);
+double bestOf(const command *c, const char *binDir, const char *launcher, int workers, long long size, int repeats);
+double amdahlSerialFraction(const int *workers, const double *speedups, int count);
+void printUsage(const char *name);
+
+// usage: benchmark [-b NAME,...] [-s SIZE,...] [-p WORKERS,...] [-r REPEATS] [-d BIN_DIR] [-l LAUNCHER]
+//   LAUNCHER is everything before the process count, default "mpirun -np"
+// build: gcc -O2 benchmark.c -o benchmark
+int main(int argc, char *argv[]){
+    const char *selected = NULL;
+    const char *binDir = ".";
+    const char *launcher = "mpirun -np";
+    long long sizes[MAX_LIST], workerList[MAX_LIST];
+    int numSizes = 0;
+    int numWorkers = parseList("1,2,4", workerList);
+    int repeats = 3;
+
+    int badArgs = argc % 2 == 0;
+    for (int i = 1; i + 1 < argc; i += 2){
+        if (strcmp(argv[i], "-b") == 0)
+            selected = argv[i + 1];
+        else if (strcmp(argv[i], "-s") == 0)
+            badArgs |= (numSizes = parseList(argv[i + 1], sizes)) < 1;
+        else if (strcmp(argv[i], "-p") == 0)
+            badArgs |= (numWorkers = parseList(argv[i + 1], workerList)) < 1;
+        else if (strcmp(argv[i], "-r") == 0)
+            badArgs |= (repeats = atoi(argv[i + 1])) < 1;
+        else if (strcmp(argv[i], "-d") == 0)
+            binDir = argv[i + 1];
+        else if (strcmp(argv[i], "-l") == 0)
+            launcher = argv[i + 1];
+        else
+            badArgs = 1;
+    }
+    //Run only the benchmarks named in -b, when it is given
+    int chosen[NUM_BENCHMARKS];
+    for (int b = 0; b < NUM_BENCHMARKS; b++)
+        chosen[b] = selected == NULL;
+    if (selected != NULL){
+        char names[256];
+        snprintf(names, sizeof(names), "%s", selected);
+        for (char *name = strtok(names, ","); name != NULL; name = strtok(NULL, ",")){
+            int b = 0;
+            while (b < NUM_BENCHMARKS && strcmp(benchmarks[b].name, name) != 0)
+                b++;
+            if (b == NUM_BENCHMARKS)
+                badArgs = 1;
+            else
+                chosen[b] = 1;
+        }
+    }
+    if (badArgs){
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    printf("benchmark,size,workers,serial_seconds,parallel_seconds,speedup,efficiency,amdahl_serial_fraction\n");
+    fflush(stdout);
+    int failed = 0;
+    for (int b = 0; b < NUM_BENCHMARKS; b++){
+        const benchmark *bench = &benchmarks[b];
+        if (!chosen[b])
+            continue;
+
+        //Sizes from -s, or the benchmark's own
+        const long long *benchSizes = numSizes > 0 ? sizes : bench->sizes;
+        int numBenchSizes = numSizes;
+        if (numSizes == 0){
+            for (numBenchSizes = 0; bench->sizes[numBenchSizes] > 0; numBenchSizes++);
+        }
+
+        for (int s = 0; s < numBenchSizes; s++){
+            long long n = benchSizes[s];
+            double serial = bestOf(&bench->serial, binDir, launcher, 1, n, repeats);
+            if (serial < 0){
+                failed = 1;
+                continue;
+            }
+
+            //Time every worker count first, as the Amdahl fit needs all of them
+            int workers[MAX_LIST];
+            double parallel[MAX_LIST], speedups[MAX_LIST];
+            int count = 0;
+            for (int w = 0; w < numWorkers; w++){
+                double t = bestOf(&bench->parallel, binDir, launcher, (int)workerList[w], n, repeats);
+                if (t <= 0){
+                    failed = 1;
+                    continue;
+                }
+                workers[count] = (int)workerList[w];
+                parallel[count] = t;
+                speedups[count] = serial / t;
+                count++;
+            }
+            double f = amdahlSerialFraction(workers, speedups, count);
+            for (int k = 0; k < count; k++){
+                printf("%s,%lld,%d,%.6f,%.6f,%.4f,%.4f,", bench->name, n, workers[k], serial, parallel[k],
+                       speedups[k], speedups[k] / workers[k]);
+                if (f >= 0)
+                    printf("%.4f", f);
+                printf("\n");
+            }
+            fflush(stdout);
+        }
+    }
+    return failed;
+}
+
+//Reads comma separated positive numbers such as "1,2,4" or "1e7,1e8". Returns how
+//many were read, or 0 if any is not a positive number.
+int parseList(const char *text, long long *values){
+    int count = 0;
+    const char *p = text;
+    while (*p != '\0' && count < MAX_LIST){
+        char *end;
+        double value = strtod(p, &end);
+        if (end == p || value < 1 || (*end != ',' && *end != '\0'))
+            return 0;
+        values[count++] = (long long)value;
+        p = *end == ',' ? end + 1 : end;
+    }
+    return count;
+}
+
+//Runs the command once and returns its wall time in seconds, or -1 if it could not
+//be started or did not exit cleanly
+double runCommand(const command *c, const char *binDir, const char *launcher, int workers, long long size){
+    char text[1024], program[1024], workerText[32], sizeText[32];
+    char *args[MAX_ARGS + 1];
+    int numArgs = 0;
+    snprintf(workerText, sizeof(workerText), "%d", workers);
+    snprintf(sizeText, sizeof(sizeText), "%lld", size);
+
+    //Launcher words and the process count come first for MPI programs
+    if (c->useMPI){
+        snprintf(text, sizeof(text), "%s %d ", launcher, workers);
+    } else {
+        text[0] = '\0';
+    }
+    size_t launchLen = strlen(text);
+    snprintf(text + launchLen, sizeof(text) - launchLen, "%s", c->args);
+    for (char *word = strtok(text, " "); word != NULL && numArgs < MAX_ARGS; word = strtok(NULL, " ")){
+        if (strcmp(word, "{p}") == 0)
+            args[numArgs++] = workerText;
+        else if (strcmp(word, "{n}") == 0)
+            args[numArgs++] = sizeText;
+        else
+            args[numArgs++] = word;
+        //The program itself is found in binDir
+        if (word == text + launchLen){
+            snprintf(program, sizeof(program), "%s/%s", binDir, word);
+            args[numArgs - 1] = program;
+        }
+    }
+    args[numArgs] = NULL;
+
+    int input[2];
+    if (pipe(input) != 0)
+        return -1;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pid_t pid = fork();
+    if (pid == 0){
+        int devNull = open("/dev/null", O_WRONLY);
+        dup2(input[0], STDIN_FILENO);
+        dup2(devNull, STDOUT_FILENO);
+        dup2(devNull, STDERR_FILENO);
+        close(input[0]);
+        close(input[1]);
+        close(devNull);
+        execvp(args[0], args);
+        _exit(127);
+    }
+    close(input[0]);
+    if (pid < 0){
+        close(input[1]);
+        return -1;
+    }
+
+    //Answer the program's prompt, then close stdin so nothing else waits on it
+    if (c->sizeOnStdin){
+        char line[32];
+        int len = snprintf(line, sizeof(line), "%lld\n", size);
+        if (write(input[1], line, len) != len)
+            fprintf(stderr, "benchmark: could not send the size to %s\n", c->args);
+    }
+    close(input[1]);
+    int status;
+    waitpid(pid, &status, 0);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0){
+        fprintf(stderr, "benchmark: %s (%d workers, size %lld) failed\n", c->args, workers, size);
+        return -1;
+    }
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+}
+
+//Shortest of repeated runs, which is the least disturbed by other work on the machine.
+//Serial runs are remembered by command and size.
+double bestOf(const command *c, const char *binDir, const char *launcher, int workers, long long size, int repeats){
+    int isSerial = c->useMPI == 0 && strstr(c->args, "{p}") == NULL;
+    if (isSerial){
+        for (int i = 0; i < numSerialTimes; i++)
+            if (strcmp(serialTimes[i].args, c->args) == 0 && serialTimes[i].size == size)
+                return serialTimes[i].seconds;
+    }
+    double best = -1;
+    for (int r = 0; r < repeats; r++){
+        double t = runCommand(c, binDir, launcher, workers, size);
+        if (t < 0)
+            return -1;
+        if (best < 0 || t < best)
+            best = t;
+    }
+    if (isSerial && numSerialTimes < MAX_SERIAL_TIMES){
+        serialTimes[numSerialTimes].args = c->args;
+        serialTimes[numSerialTimes].size = size;
+        serialTimes[numSerialTimes].seconds = best;
+        numSerialTimes++;
+    }
+    return best;
+}
+
+//Least squares fit of Amdahl's law S(p) = 1 / (f + (1 - f) / p) for the serial
+//fraction f. Rearranged, 1/S - 1/p = f (1 - 1/p) is a line through the origin.
+//Returns -1 if there is no run with more than one worker to fit to.
+double amdahlSerialFraction(const int *workers, const double *speedups, int count){
+    double sxy = 0.0, sxx = 0.0;
+    for (int k = 0; k < count; k++){
+        double x = 1.0 - 1.0 / workers[k];
+        double y = 1.0 / speedups[k] - 1.0 / workers[k];
+        sxy += x * y;
+        sxx += x * x;
+    }
+    if (sxx == 0.0)
+        return -1;
+    double f = sxy / sxx;
+    //Overheads can make the best fit exceed 1, and superlinear runs push it below 0
+    if (f < 0.0)
+        f = 0.0;
+    if (f > 1.0)
+        f = 1.0;
+    return f;
+}
+
+void printUsage(const char *name){
+    printf("usage: %s [-b NAME,...] [-s SIZE,...] [-p WORKERS,...] [-r REPEATS] [-d BIN_DIR] [-l LAUNCHER]\nbenchmarks:", name);
+    for (int b = 0; b < NUM_BENCHMARKS; b++)
+        printf(" %s", benchmarks[b].name);
+    printf("\n");
+}
@@ -3,39 +3,81 @@
 //
 // Author: http://www.c.happycodings.com/Sorting_Searching/code11.html
 //		- Initial version
+//		- Runtime-sized arrays, sorted by the single-buffer bottom-up mergesort in sort_merge.c
+//		- Counting/radix sort (sort_radix.c) as an alternative algorithm
+//		- Fork-join threaded mergesort with merge-path merges (sort_parallel.c) for more than one thread
 //
 //---------------------------------------------------------------------------------------------------------------------
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
+#include "sort_merge.h"
+#include "sort_parallel.h"
+#include "sort_radix.h"
 
-// Data
+// Default size of the data
 #define MAXARRAY 100000
 
-// Function prototype
-void mergeSort(int[], int, int);
-
 // Main program
-int main(void)
+// usage: q1_timer [-a merge|radix] [-t THREADS] [N]   (N defaults to MAXARRAY, threads to 1)
+// build: gcc -O2 q1_timer.c sort_merge.c sort_parallel.c sort_radix.c -lpthread
+int main(int argc, char *argv[])
 {
-	int data[MAXARRAY];
-	int i = 0;
+	int *data;
+	long long n = MAXARRAY;
+	long long i = 0;
+	int useRadix = 0;
+	int numThreads = 1;
+	int badArgs = 0;
 	FILE *pOutfile;
-	clock_t start, end;
+	struct timespec start, end;
 	double cpu_time_used;
 
-	// Start timer
-    start = clock();
+	// Algorithm, radix sort threads and size of the data may be given on the command line
+	for(i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-a") == 0 && i + 1 < argc && (strcmp(argv[i + 1], "merge") == 0 || strcmp(argv[i + 1], "radix") == 0))
+		{
+			useRadix = strcmp(argv[++i], "radix") == 0;
+		}
+		else if(strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			numThreads = atoi(argv[++i]);
+		}
+		else if(argv[i][0] != '-')
+		{
+			n = atoll(argv[i]);
+		}
+		else
+		{
+			badArgs = 1;
+		}
+	}
+	if(n < 1 || numThreads < 1 || badArgs)
+	{
+		printf("usage: %s [-a merge|radix] [-t THREADS] [N]\n", argv[0]);
+		return 1;
+	}
+	data = (int*)malloc(n * sizeof(int));
+	if(data == NULL)
+	{
+		printf("Not enough memory for %lld numbers\n", n);
+		return 1;
+	}
+
+	// Start timer. Wall time, as clock() would add up the time of every thread
+	clock_gettime(CLOCK_MONOTONIC, &start);
 	
 	// Load random data into the array
 	// Note: Time(NULL) function is not used here.
 	// Hence, random number generated will be same every time the application is executed.
 	// This makes it easier to view the sorted results.
-	for(i = 0; i < MAXARRAY; i++)
+	for(i = 0; i < n; i++)
 	{
 		data[i] = rand() % 100; 
 	}
-	printf("Finished generating %d numbers in array \n", MAXARRAY);
+	printf("Finished generating %lld numbers in array \n", n);
 
 	// Print data before sorting
 	printf("Before Sorting:\n");
@@ -45,73 +87,29 @@ int main(void)
 	// }
 	// printf("\n");
 
-	// Call the merge sort function
-	mergeSort(data, 0, MAXARRAY - 1);
+	// Call the chosen sort function
+	if((useRadix ? radixSortInts(data, n, numThreads) : parallelMergeSortInts(data, n, numThreads)) != 0)
+	{
+		printf("Not enough memory for the sort buffer\n");
+		free(data);
+		return 1;
+	}
 
 	// Write data after sorting
 	pOutfile = fopen("sorted_serial.txt","w+");
 	printf("\n");
-	printf("Writing to file after sorting using Mergesort:\n");
-	for(i = 0; i < MAXARRAY; i++)
+	printf("Writing to file after sorting using %s:\n", useRadix ? "Radix sort" : "Mergesort");
+	for(i = 0; i < n; i++)
 	{
 		fprintf(pOutfile," %d", data[i]);
 	}
+	fclose(pOutfile);
 	printf("\n");
 	// End timer and print duration
-    end = clock();
-    cpu_time_used = ((double) (end - start)) / CLOCKS_PER_SEC;
-    printf("This program took %f to execute\n", cpu_time_used);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	cpu_time_used = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+	printf("This program took %f to execute\n", cpu_time_used);
 
+	free(data);
 	return 0;
 }
-
-// Function definition
-void mergeSort(int inputData[], int startPoint, int endPoint)
-{
-	int i = 0;
-	int length = endPoint - startPoint + 1;
-	int pivot  = 0;
-	int merge1 = 0;
-	int merge2 = 0;
-	int working[MAXARRAY] = {0};
-
-	if(startPoint == endPoint)
-	{
-		return;
-	}
-	pivot  = (startPoint + endPoint) / 2;
-
-	// Recursive function call
-	mergeSort(inputData, startPoint, pivot);
-	mergeSort(inputData, pivot + 1, endPoint);
-
-	for(i = 0; i < length; i++)
-	{
-		working[i] = inputData[startPoint + i];
-	}
-
-	merge1 = 0;
-	merge2 = pivot - startPoint + 1;
-
-	for(i = 0; i < length; i++)
-	{
-		if(merge2 <= endPoint - startPoint)
-			if(merge1 <= pivot - startPoint)
-				if(working[merge1] > working[merge2])
-				{
-					inputData[i + startPoint] = working[merge2++];
-				}
-				else
-				{
-					inputData[i + startPoint] = working[merge1++];
-				}
-			else
-			{
-				inputData[i + startPoint] = working[merge2++];
-			}
-		else
-		{
-			inputData[i + startPoint] = working[merge1++];
-		}
-	}
-}
\ No newline at end of file
@@ -4,17 +4,28 @@
 // The problem is solved by not printing the 1000 unsorted data
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <mpi.h>
+#include "sort_merge.h"
+#include "sort_radix.h"
+#include "sort_kway.h"
+#include "sort_sample.h"
+#include "sort_mpiio.h"
 
-// Define the size of data
+// Default size of data
 #define N 100000
 
 // Function Prototype
-void mergeSort(int* data, int startPoint, int endPoint); 
-void merge(int *A, int sizeA, int *B, int sizeB);
+int sampleSortRun(long long n, int p, int myRank, int useRadix, int numThreads);
 
 // Main Function
+// usage: mpirun -np P q2_timer [-m tree|sample] [-a merge|radix] [-t THREADS] [N]   (N defaults to 100000)
+//   tree:   rank 0 generates the data and scatters it down a binary tree, then gathers the
+//           sorted chunks back and merges them all at once
+//   sample: every rank generates its own share and the data is sample sorted in place
+//   -a picks how each rank sorts its own share; radix sort uses THREADS threads per rank (default 1)
+// build: mpicc -O2 q2_timer.c sort_merge.c sort_radix.c sort_kway.c sort_sample.c sort_mpiio.c -lm -lpthread
 int main(int argc, char* argv[])
 {
 	// Variable declaration
@@ -42,6 +53,37 @@ int main(int argc, char* argv[])
 	MPI_Comm_size(MPI_COMM_WORLD,&p);
 	MPI_Comm_rank(MPI_COMM_WORLD,&myRank);
 
+	// Every process reads the same arguments
+	long long n = N;
+	int useSample = 0;
+	int useRadix = 0;
+	int numThreads = 1;
+	int badArgs = 0;
+	for(i = 1; i < argc; i++){
+		if(strcmp(argv[i], "-m") == 0 && i + 1 < argc && (strcmp(argv[i + 1], "tree") == 0 || strcmp(argv[i + 1], "sample") == 0))
+			useSample = strcmp(argv[++i], "sample") == 0;
+		else if(strcmp(argv[i], "-a") == 0 && i + 1 < argc && (strcmp(argv[i + 1], "merge") == 0 || strcmp(argv[i + 1], "radix") == 0))
+			useRadix = strcmp(argv[++i], "radix") == 0;
+		else if(strcmp(argv[i], "-t") == 0 && i + 1 < argc && (numThreads = atoi(argv[i + 1])) > 0)
+			i++;
+		else if(argv[i][0] != '-' && (n = atoll(argv[i])) > 0)
+			continue;
+		else
+			badArgs = 1;
+	}
+	// The tree sort keeps everything on rank 0 and counts with ints
+	if(badArgs || n < 1 || (!useSample && n > 2147483647LL)){
+		if(myRank == 0)
+			printf("usage: %s [-m tree|sample] [-a merge|radix] [-t THREADS] [N]   (N below 2^31 for tree)\n", argv[0]);
+		MPI_Finalize();
+		return 1;
+	}
+	if(useSample){
+		int result = sampleSortRun(n, p, myRank, useRadix, numThreads);
+		MPI_Finalize();
+		return result;
+	}
+
 	// Start timer
     MPI_Barrier(MPI_COMM_WORLD); /* IMPORTANT */
 	start = MPI_Wtime();
@@ -50,13 +92,13 @@ int main(int argc, char* argv[])
 		printf("Starting Program\n");							
 		// Root Node:
 		maxLevel = log ((double)p) / log(2.00);	// Calculate the maximum level of binary tree
-		length = N;	// Set the length of root node to N
+		length = (int)n;	// Set the length of root node to n
 		data = (int*)malloc(length * sizeof(int)); // Create dynamic array buffer with size length	
 		
 		// srand is not used to keep a constant set of random values at each program execution for better debugging
-		for(i = 0; i<N;i++)							
+		for(i = 0; i<length;i++)							
 			data[i] = rand()%100;
-		printf("Finished generating %d numbers in array \n", N);
+		printf("Finished generating %d numbers in array \n", length);
 		// printf("\n-----------------------------------------------------------------------------\n");
 		// printf("Unsorted Data: \n");
 		// for(i = 0; i<N; i++){	// Prints out unsorted data value
@@ -102,42 +144,63 @@ int main(int argc, char* argv[])
 		}
 	}
 	
-	// All processors mergeSort their own data chunk with respective length
-	mergeSort(data,0,length -1);		
+	// All processors sort their own data chunk with respective length
+	if(useRadix){
+		if(radixSortInts(data, length, numThreads) != 0){
+			printf("Not enough memory for the radix sort buffer on rank %d\n", myRank);
+			MPI_Abort(MPI_COMM_WORLD, 1);
+		}
+	}
+	// Same single-buffer mergesort as q1_timer, so the benchmark's speedup only measures the parallelism
+	else if(mergeSortInts(data, length) != 0){
+		printf("Not enough memory for the mergesort buffer on rank %d\n", myRank);
+		MPI_Abort(MPI_COMM_WORLD, 1);
+	}
 
-	// Merge the sorted data from child node to the root node starting 
-	// Begin the progress from the lowest level of the tree structure
-	for(currentLevel = maxLevel;currentLevel>=0;currentLevel--){
-		scale = pow(2.00, currentLevel);
-		if(myRank/scale<1){							// Parent node receive sorted data from child node
-			if(myRank+scale<p)						// If child node exist (child node rank < number of processors)
-			{						
-				MPI_Recv(&rightLength, 1, MPI_INT, myRank+scale, currentLevel, MPI_COMM_WORLD,&status);
-				MPI_Recv((int *) data+ length, rightLength, MPI_INT, myRank+scale, currentLevel, MPI_COMM_WORLD, &status);
-
-				merge(data, length, (int *)data+length, rightLength);	// Merge the data array
-				length+=rightLength; // Update the length of merged data array
-			}
+	// Gather every sorted chunk into the root's buffer, one after another, and merge
+	// them all in one pass with a loser tree instead of pairwise up the tree
+	int *counts = NULL;
+	int *displs = NULL;
+	if(myRank == 0){
+		counts = (int*)malloc(p * sizeof(int));
+		displs = (int*)malloc(p * sizeof(int));
+	}
+	MPI_Gather(&length, 1, MPI_INT, counts, 1, MPI_INT, 0, MPI_COMM_WORLD);
+	if(myRank == 0){
+		size_t *bounds = (size_t*)malloc((p + 1) * sizeof(size_t));
+		bounds[0] = 0;
+		for(i = 0; i < p; i++){
+			displs[i] = (int)bounds[i];
+			bounds[i + 1] = bounds[i] + counts[i];
 		}
-		// Child node sends sorted data to parent node
-		// tag = current level
-		else if(myRank/scale<2)
-		{
-			// Send the length of sorted data
-			MPI_Send(&length, 1, MPI_INT, myRank-scale,currentLevel, MPI_COMM_WORLD);
-			MPI_Send(data, length, MPI_INT, myRank-scale, currentLevel, MPI_COMM_WORLD);
+		// The root's own chunk is already at the start of its buffer
+		MPI_Gatherv(MPI_IN_PLACE, length, MPI_INT, data, counts, displs, MPI_INT, 0, MPI_COMM_WORLD);
+		int *merged = (int*)malloc(n * sizeof(int));
+		if(merged == NULL || kwayMergeInts(merged, data, bounds, p) != 0){
+			printf("Not enough memory to merge on the root\n");
+			MPI_Abort(MPI_COMM_WORLD, 1);
 		}
+		free(data);
+		data = merged;
+		length = (int)n;
+		free(bounds);
+		free(counts);
+		free(displs);
 	}
+	else
+		MPI_Gatherv(data, length, MPI_INT, NULL, NULL, NULL, MPI_INT, 0, MPI_COMM_WORLD);
 	
-	// Root node writes the sorted data
-	pOutfile = fopen("sorted_parallel.txt","w+");
+	// Root node writes the sorted data. Only the root opens the file, so no other
+	// rank can truncate it while the root is writing.
 	if(myRank == 0){
+		pOutfile = fopen("sorted_parallel.txt","w+");
 		printf("Writing to file after sorting using Mergesort:\n");
 		for(i = 0; i<length;i++){
 			if(i%10 == 0)
 				fprintf(pOutfile,"\n");
 			fprintf(pOutfile,"%d\t", data[i]);
 		}
+		fclose(pOutfile);
 		printf("\n");
 	}
 
@@ -158,52 +221,116 @@ int main(int argc, char* argv[])
 }
 // End of main program
 
-// Function mergeSort
-void mergeSort(int* data, int startPoint, int endPoint)
+// Function sampleSortRun
+// Each rank generates and sorts its own share, then the shares are sample sorted so
+// rank i ends up with the i-th part of the sorted data. Nothing is gathered to rank 0:
+// the file is written by all ranks together. Returns 0 if the result checks out.
+int sampleSortRun(long long n, int p, int myRank, int useRadix, int numThreads)
 {
-	int pivot = (startPoint + endPoint)/2;
-	
-	// if last element then return
-	if(startPoint == endPoint)
-		return;
-	//Recursive function call
-	mergeSort(data, startPoint, pivot);
-	mergeSort(data,pivot+1,endPoint);
-	
-	// Merge the sorted data from both sides into the data buffer
-	merge(data+startPoint, pivot - startPoint +1, data+pivot+1, endPoint-pivot);
-}
-// End of function mergeSort
+	double start, generated, sortedLocal, sorted, written;
+	double times[6], slowest[6];
+	sampleSortTimes steps;
+	long long i;
+	long long first = n * myRank / p;
+	size_t length = (size_t)(n * (myRank + 1) / p - first);
+	int *data = (int*)malloc((length > 0 ? length : 1) * sizeof(int));
+	int *part = NULL;
+	size_t partLength = 0;
+	int failed = data == NULL;
+	int anyFailed;
 
-// Function merge
-void merge(int *A, int sizeA, int *B, int sizeB)
-{
-	int sizeC = sizeA + sizeB;
-	int *C = (int*)malloc(sizeC * sizeof(int));
-	int countA;
-	int countB;
-	int countC;
-	// Merging the element from array A and array B into C in ascending order
-	for(countA = 0, countB = 0, countC = 0; countC< sizeC; countC++){
-		if(countA>=sizeA)					// If all the element from A is stored into C
-			C[countC] = B[countB++];	// store the remaining element from B into C
-		else if (countB>=sizeB)			// If all the element from B is stored into C
-			C[countC] = A[countA++];		// store the remaining element from  A into C
-		else
-		{	// Store the element with smaller value into C then increment the corresponding pointer array (A or B)
-			if(A[countA]<=B[countB])			
-				C[countC] = A[countA++];
-			else C[countC] = B[countB++];
+	MPI_Barrier(MPI_COMM_WORLD); /* IMPORTANT */
+	start = MPI_Wtime();
+	if(myRank == 0)
+		printf("Starting Program\n");
+
+	// Each rank draws from its own seed, so no rank needs the whole data
+	unsigned int seed = (unsigned int)myRank + 1;
+	long long localSum = 0, globalSumBefore = 0, globalSumAfter = 0;
+	for(i = 0; i < (long long)length && !failed; i++){
+		data[i] = rand_r(&seed) % 100;
+		localSum += data[i];
+	}
+	MPI_Reduce(&localSum, &globalSumBefore, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+	if(myRank == 0)
+		printf("Finished generating %lld numbers across %d processors \n", n, p);
+	generated = MPI_Wtime();
+
+	// Sort the local share, then sample sort across ranks
+	if(!failed)
+		failed = (useRadix ? radixSortInts(data, length, numThreads) : mergeSortInts(data, length)) != 0;
+	sortedLocal = MPI_Wtime();
+	MPI_Allreduce(&failed, &anyFailed, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+	if(anyFailed || sampleSortInts(MPI_COMM_WORLD, data, length, &part, &partLength, &steps) != 0){
+		if(myRank == 0)
+			printf("Not enough memory to sort %lld numbers\n", n);
+		free(data);
+		return 1;
+	}
+	free(data);
+	sorted = MPI_Wtime();
+
+	// Check the result: each part is in order, follows the part before it, and the
+	// numbers add up to what was generated
+	int bad = 0;
+	localSum = 0;
+	for(i = 0; i < (long long)partLength; i++){
+		localSum += part[i];
+		if(i > 0 && part[i - 1] > part[i])
+			bad = 1;
+	}
+	// Compare the first number with the last number of the nearest non-empty part before
+	// it (the numbers are never negative, so -1 marks an empty part)
+	long long myLast = partLength > 0 ? part[partLength - 1] : -1;
+	long long *lasts = (long long*)malloc(p * sizeof(long long));
+	MPI_Allgather(&myLast, 1, MPI_LONG_LONG, lasts, 1, MPI_LONG_LONG, MPI_COMM_WORLD);
+	for(int r = myRank - 1; r >= 0 && partLength > 0; r--){
+		if(lasts[r] >= 0){
+			if(part[0] < lasts[r])
+				bad = 1;
+			break;
 		}
 	}
-	// Copy the merged data from C into A and B 
-	for(countA = 0; countA < sizeA; countA++)
-		A[countA] = C[countA];
-	
-	for(countC = countA, countB = 0; countC < sizeC; countC++, countB++)
-		B[countB] = C[countC];
-	
-	// Free memory of C
-	free(C);
+	free(lasts);
+	int anyBad = 0;
+	MPI_Reduce(&bad, &anyBad, 1, MPI_INT, MPI_LOR, 0, MPI_COMM_WORLD);
+	MPI_Reduce(&localSum, &globalSumAfter, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+
+	// All ranks write their parts of the file together
+	if(myRank == 0)
+		printf("Writing to file after sorting using sample sort:\n");
+	if(sortedWriteMPI(MPI_COMM_WORLD, "sorted_parallel.txt", part, partLength) != 0){
+		if(myRank == 0)
+			printf("Could not write sorted_parallel.txt\n");
+		anyBad = 1;
+	}
+	MPI_Barrier(MPI_COMM_WORLD); /* IMPORTANT */
+	written = MPI_Wtime();
+
+	// Slowest rank at each step, and how evenly the parts came out
+	times[0] = generated - start;
+	times[1] = sortedLocal - generated;
+	times[2] = steps.splitters;
+	times[3] = steps.exchange;
+	times[4] = steps.merge;
+	times[5] = written - sorted;
+	MPI_Reduce(times, slowest, 6, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+	unsigned long long myPart = partLength, largestPart, smallestPart;
+	MPI_Reduce(&myPart, &largestPart, 1, MPI_UNSIGNED_LONG_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+	MPI_Reduce(&myPart, &smallestPart, 1, MPI_UNSIGNED_LONG_LONG, MPI_MIN, 0, MPI_COMM_WORLD);
+	free(part);
+
+	if(myRank == 0){
+		if(globalSumAfter != globalSumBefore)
+			anyBad = 1;
+		printf("\n");
+		printf("Slowest rank: generate %f, local sort %f, splitters %f, exchange %f, merge %f, write %f\n",
+		       slowest[0], slowest[1], slowest[2], slowest[3], slowest[4], slowest[5]);
+		printf("Part sizes: smallest %llu, largest %llu (%.3f of an even share)\n",
+		       smallestPart, largestPart, largestPart / ((double)n / p));
+		printf(anyBad ? "Check FAILED: the parts are not in order\n" : "Check passed: the parts are in order\n");
+		printf("This program took %f to execute\n", written - start);
+	}
+	return anyBad;
 }
-// End of function merge
\ No newline at end of file
+// End of function sampleSortRun
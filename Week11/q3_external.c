@@ -0,0 +1,182 @@
+//---------------------------------------------------------------------------------------------------------------------
+// External-memory sort of a binary file of ints, for datasets larger than RAM
+//
+// The input is streamed through memory-sized sorted runs on disk, which are then k-way merged into the output
+// (see sort_external.h). With -g the input is first generated with rand() % 100 like the other sorters.
+//
+//---------------------------------------------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sort_external.h"
+
+// Default memory budget in MiB, and the least that leaves room to merge two runs
+#define DEFAULT_MEMORY_MB 256
+#define MIN_MEMORY_MB (4 * EXTERNAL_MIN_BLOCK_BYTES >> 20)
+// Numbers written or checked at a time
+#define IO_BLOCK (1 << 20)
+
+// Function prototype
+int generateInput(const char *filename, long long n, long long *sum);
+int checkOutput(const char *filename, unsigned long long *count, long long *sum);
+double elapsedSeconds(struct timespec start, struct timespec end);
+
+// Main program
+// usage: q3_external [-a merge|radix] [-t THREADS] [-M MEMORY_MB] [-g N] INPUT OUTPUT
+//   -g N writes N random numbers to INPUT first; without it INPUT must already exist
+// build: gcc -O2 q3_external.c sort_external.c sort_kway.c sort_merge.c sort_parallel.c sort_radix.c -lpthread
+int main(int argc, char *argv[])
+{
+	int useRadix = 0;
+	int numThreads = 1;
+	long long memoryMB = DEFAULT_MEMORY_MB;
+	long long generate = 0;
+	const char *names[2];
+	int numNames = 0;
+	int badArgs = 0;
+	int i;
+	struct timespec start, end;
+	long long sumBefore = 0, sumAfter = 0;
+	unsigned long long count = 0;
+	externalSortStats stats;
+
+	for(i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-a") == 0 && i + 1 < argc && (strcmp(argv[i + 1], "merge") == 0 || strcmp(argv[i + 1], "radix") == 0))
+		{
+			useRadix = strcmp(argv[++i], "radix") == 0;
+		}
+		else if(strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			numThreads = atoi(argv[++i]);
+		}
+		else if(strcmp(argv[i], "-M") == 0 && i + 1 < argc)
+		{
+			memoryMB = atoll(argv[++i]);
+		}
+		else if(strcmp(argv[i], "-g") == 0 && i + 1 < argc)
+		{
+			generate = (long long)atof(argv[++i]);
+			badArgs |= generate < 1;
+		}
+		else if(argv[i][0] != '-' && numNames < 2)
+		{
+			names[numNames++] = argv[i];
+		}
+		else
+		{
+			badArgs = 1;
+		}
+	}
+	if(badArgs || numNames != 2 || numThreads < 1 || memoryMB < MIN_MEMORY_MB)
+	{
+		printf("usage: %s [-a merge|radix] [-t THREADS] [-M MEMORY_MB] [-g N] INPUT OUTPUT   (MEMORY_MB at least %d)\n", argv[0], MIN_MEMORY_MB);
+		return 1;
+	}
+
+	if(generate > 0)
+	{
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		if(generateInput(names[0], generate, &sumBefore) != 0)
+		{
+			perror(names[0]);
+			return 1;
+		}
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		printf("Finished generating %lld numbers in %s (%f s)\n", generate, names[0], elapsedSeconds(start, end));
+	}
+
+	// Sort
+	printf("Sorting %s into %s with %lld MiB of memory and %d threads:\n", names[0], names[1], memoryMB, numThreads);
+	fflush(stdout);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	if(externalSortInts(names[0], names[1], (size_t)memoryMB << 20, numThreads, useRadix, &stats) != 0)
+	{
+		perror("External sort failed");
+		return 1;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double seconds = elapsedSeconds(start, end);
+	double megabytes = stats.bytes / 1048576.0;
+	printf("Runs: %d written in %f s (%.1f MB/s)\n", stats.numRuns, stats.runSeconds, megabytes / stats.runSeconds);
+	printf("Merge: %d passes in %f s (%.1f MB/s)\n", stats.mergePasses, stats.mergeSeconds,
+	       stats.mergePasses > 0 ? megabytes * stats.mergePasses / stats.mergeSeconds : 0.0);
+	printf("Sorted %.1f MB, %.1f times the memory budget, at %.1f MB/s overall\n", megabytes, megabytes / memoryMB, megabytes / seconds);
+
+	// Check the output is in order and has every number
+	if(checkOutput(names[1], &count, &sumAfter) != 0)
+	{
+		printf("Check FAILED: %s is not in order\n", names[1]);
+		return 1;
+	}
+	if(count * sizeof(int) != stats.bytes || (generate > 0 && sumAfter != sumBefore))
+	{
+		printf("Check FAILED: %s does not hold the same numbers as %s\n", names[1], names[0]);
+		return 1;
+	}
+	printf("Check passed: %llu numbers in order\n", count);
+	printf("This program took %f to execute\n", seconds);
+	return 0;
+}
+
+// Function generateInput
+// Writes n numbers from rand() % 100, a block at a time, and adds them up
+int generateInput(const char *filename, long long n, long long *sum)
+{
+	FILE *pOutfile = fopen(filename, "wb");
+	int *block = (int*)malloc(IO_BLOCK * sizeof(int));
+	long long i = 0;
+	int ok = pOutfile != NULL && block != NULL;
+	*sum = 0;
+	while(ok && i < n)
+	{
+		size_t len = n - i < IO_BLOCK ? (size_t)(n - i) : IO_BLOCK;
+		for(size_t j = 0; j < len; j++)
+		{
+			block[j] = rand() % 100;
+			*sum += block[j];
+		}
+		ok = fwrite(block, sizeof(int), len, pOutfile) == len;
+		i += len;
+	}
+	if(pOutfile != NULL && fclose(pOutfile) != 0)
+		ok = 0;
+	free(block);
+	return ok ? 0 : -1;
+}
+// End of function generateInput
+
+// Function checkOutput
+// Streams the file through once, checking the order and counting and adding up the numbers
+int checkOutput(const char *filename, unsigned long long *count, long long *sum)
+{
+	FILE *pInfile = fopen(filename, "rb");
+	int *block = (int*)malloc(IO_BLOCK * sizeof(int));
+	int ok = pInfile != NULL && block != NULL;
+	int previous = 0;
+	size_t len;
+	*count = 0;
+	*sum = 0;
+	while(ok && (len = fread(block, sizeof(int), IO_BLOCK, pInfile)) > 0)
+	{
+		for(size_t j = 0; j < len; j++)
+		{
+			if(*count + j > 0 && block[j] < previous)
+				ok = 0;
+			previous = block[j];
+			*sum += block[j];
+		}
+		*count += len;
+	}
+	if(pInfile != NULL)
+		fclose(pInfile);
+	free(block);
+	return ok ? 0 : -1;
+}
+// End of function checkOutput
+
+double elapsedSeconds(struct timespec start, struct timespec end)
+{
+	return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+}
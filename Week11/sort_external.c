@@ -0,0 +1,265 @@
+/*
+ * External sort: memory-sized sorted runs on disk, then block-wise loser-tree merges.
+ */
+#include "sort_external.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include "sort_kway.h"
+#include "sort_parallel.h"
+#include "sort_radix.h"
+
+//Function Declarations
+static double nowSeconds(void);
+static char *runName(const char *output, int pass, int index);
+static size_t upperBound(const int *data, size_t n, int bound);
+static int mergeRunFiles(char **names, int k, const char *outName, size_t memoryBytes);
+static void removeRuns(char **names, int k);
+
+static double nowSeconds(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static char *runName(const char *output, int pass, int index)
+{
+    size_t len = strlen(output) + 32;
+    char *name = (char*)malloc(len);
+    if (name != NULL)
+        snprintf(name, len, "%s.run%d.%d", output, pass, index);
+    return name;
+}
+
+//Number of keys in sorted data that are <= bound
+static size_t upperBound(const int *data, size_t n, int bound)
+{
+    size_t lo = 0, hi = n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (data[mid] <= bound)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+static void removeRuns(char **names, int k)
+{
+    for (int r = 0; r < k; r++) {
+        if (names[r] != NULL)
+            remove(names[r]);
+        free(names[r]);
+    }
+}
+
+//Merge k sorted run files into outName, one block per run at a time
+static int mergeRunFiles(char **names, int k, const char *outName, size_t memoryBytes)
+{
+    size_t block = memoryBytes / 2 / (size_t)k / sizeof(int);
+    int *inBuf = (int*)malloc(block * k * sizeof(int));
+    int *outBuf = (int*)malloc(block * k * sizeof(int));
+    FILE **files = (FILE**)calloc((size_t)k, sizeof(FILE*));
+    const int **runs = (const int**)malloc((size_t)k * sizeof(const int*));
+    size_t *pos = (size_t*)malloc(3 * (size_t)k * sizeof(size_t));
+    int *more = (int*)malloc((size_t)k * sizeof(int));
+    FILE *out = NULL;
+    int result = -1;
+    if (inBuf == NULL || outBuf == NULL || files == NULL || runs == NULL || pos == NULL || more == NULL) {
+        errno = ENOMEM;
+        goto done;
+    }
+    size_t *len = pos + k, *take = pos + 2 * k;
+    for (int r = 0; r < k; r++) {
+        files[r] = fopen(names[r], "rb");
+        if (files[r] == NULL)
+            goto done;
+        pos[r] = len[r] = 0;
+        more[r] = 1;
+    }
+    out = fopen(outName, "wb");
+    if (out == NULL)
+        goto done;
+
+    for (;;) {
+        //Refill the runs that are used up, and find the bound among runs with more on disk
+        int active = 0, haveBound = 0, bound = 0;
+        for (int r = 0; r < k; r++) {
+            if (pos[r] == len[r] && more[r]) {
+                len[r] = fread(inBuf + r * block, sizeof(int), block, files[r]);
+                pos[r] = 0;
+                if (len[r] < block) {
+                    if (ferror(files[r]))
+                        goto done;
+                    more[r] = 0;
+                }
+            }
+            if (pos[r] < len[r]) {
+                active = 1;
+                if (more[r] && (!haveBound || inBuf[r * block + len[r] - 1] < bound)) {
+                    bound = inBuf[r * block + len[r] - 1];
+                    haveBound = 1;
+                }
+            }
+        }
+        if (!active)
+            break;
+
+        //Everything up to the bound is final; merge it out in one pass
+        size_t total = 0;
+        for (int r = 0; r < k; r++) {
+            runs[r] = inBuf + r * block + pos[r];
+            take[r] = haveBound ? upperBound(runs[r], len[r] - pos[r], bound) : len[r] - pos[r];
+            pos[r] += take[r];
+            total += take[r];
+        }
+        if (kwayMergeRunsInts(outBuf, runs, take, k) != 0) {
+            errno = ENOMEM;
+            goto done;
+        }
+        if (fwrite(outBuf, sizeof(int), total, out) != total)
+            goto done;
+    }
+    result = 0;
+
+done:
+    if (out != NULL && fclose(out) != 0)
+        result = -1;
+    for (int r = 0; files != NULL && r < k; r++) {
+        if (files[r] != NULL)
+            fclose(files[r]);
+    }
+    free(inBuf);
+    free(outBuf);
+    free(files);
+    free(runs);
+    free(pos);
+    free(more);
+    return result;
+}
+
+int externalSortInts(const char *input, const char *output, size_t memoryBytes, int numThreads, int useRadix,
+                     externalSortStats *stats)
+{
+    //Half the memory holds a run, the other half is the sort's own buffer
+    size_t runElems = memoryBytes / 2 / sizeof(int);
+    int fanIn = (int)(memoryBytes / 2 / EXTERNAL_MIN_BLOCK_BYTES);
+    if (runElems < 1 || fanIn < 2) {
+        errno = EINVAL;
+        return -1;
+    }
+    double start = nowSeconds();
+    FILE *in = fopen(input, "rb");
+    if (in == NULL)
+        return -1;
+    int *data = (int*)malloc(runElems * sizeof(int));
+    int numRuns = 0, capacity = 16;
+    char **names = (char**)malloc(capacity * sizeof(char*));
+    unsigned long long bytes = 0;
+    int failed = data == NULL || names == NULL;
+    if (failed)
+        errno = ENOMEM;
+
+    //Run formation: fill, sort in memory, write
+    while (!failed) {
+        size_t got = fread(data, 1, runElems * sizeof(int), in);
+        bytes += got;
+        if (got % sizeof(int) != 0) {
+            errno = EINVAL;
+            failed = 1;
+            break;
+        }
+        if (got == 0) {
+            failed = ferror(in) != 0;
+            break;
+        }
+        size_t n = got / sizeof(int);
+        if ((useRadix ? radixSortInts(data, n, numThreads) : parallelMergeSortInts(data, n, numThreads)) != 0) {
+            errno = ENOMEM;
+            failed = 1;
+            break;
+        }
+        if (numRuns == capacity) {
+            char **grown = (char**)realloc(names, 2 * capacity * sizeof(char*));
+            if (grown == NULL) {
+                errno = ENOMEM;
+                failed = 1;
+                break;
+            }
+            names = grown;
+            capacity *= 2;
+        }
+        names[numRuns] = runName(output, 0, numRuns);
+        FILE *run = names[numRuns] != NULL ? fopen(names[numRuns], "wb") : NULL;
+        numRuns++;
+        if (run == NULL) {
+            failed = 1;
+            break;
+        }
+        int wrote = fwrite(data, sizeof(int), n, run) == n;
+        if (fclose(run) != 0 || !wrote) {
+            failed = 1;
+            break;
+        }
+    }
+    fclose(in);
+    free(data);
+    double runsDone = nowSeconds();
+    if (failed) {
+        if (names != NULL)
+            removeRuns(names, numRuns);
+        free(names);
+        return -1;
+    }
+
+    //Merge groups of runs into longer ones until one pass can merge them all
+    int initialRuns = numRuns, passes = 0;
+    while (numRuns > fanIn) {
+        passes++;
+        int numGroups = (numRuns + fanIn - 1) / fanIn;
+        char **merged = (char**)calloc((size_t)numGroups, sizeof(char*));
+        for (int g = 0; g < numGroups && merged != NULL && !failed; g++) {
+            int first = g * fanIn;
+            int k = numRuns - first < fanIn ? numRuns - first : fanIn;
+            merged[g] = runName(output, passes, g);
+            failed = merged[g] == NULL || mergeRunFiles(names + first, k, merged[g], memoryBytes) != 0;
+        }
+        removeRuns(names, numRuns);
+        free(names);
+        names = merged;
+        if (merged == NULL || failed) {
+            if (merged != NULL)
+                removeRuns(merged, numGroups);
+            free(merged);
+            return -1;
+        }
+        numRuns = numGroups;
+    }
+
+    //Final pass into the output; a single run only needs renaming
+    if (numRuns == 0) {
+        FILE *out = fopen(output, "wb");
+        failed = out == NULL || fclose(out) != 0;
+    } else if (numRuns == 1) {
+        failed = rename(names[0], output) != 0;
+    } else {
+        passes++;
+        failed = mergeRunFiles(names, numRuns, output, memoryBytes) != 0;
+    }
+    removeRuns(names, numRuns);
+    free(names);
+    double end = nowSeconds();
+
+    if (stats != NULL) {
+        stats->bytes = bytes;
+        stats->numRuns = initialRuns;
+        stats->mergePasses = passes;
+        stats->runSeconds = runsDone - start;
+        stats->mergeSeconds = end - runsDone;
+    }
+    return failed ? -1 : 0;
+}
@@ -0,0 +1,41 @@
+/*
+ * External-memory sort of a binary file of native ints, for data larger than RAM.
+ *
+ * Run formation streams the input through a buffer of half the memory budget. Each
+ * fill is sorted by numThreads threads (the fork-join mergesort, whose leaves sort
+ * cache-sized runs, or the counting/radix sort) and written out as one run file.
+ *
+ * Merging gives each run an equal block of the other half of the memory and keeps an
+ * output block of the same total size. A round looks at the runs that still have
+ * data on disk and takes the smallest last key in their blocks as a bound. Every
+ * buffered key up to that bound can go out now, and a k-way loser-tree merge writes
+ * them all to the output block in one pass. The run that set the bound is always
+ * emptied and refilled, so every round makes progress. When there are more runs
+ * than blocks of EXTERNAL_MIN_BLOCK_BYTES fit in memory, groups of runs are merged
+ * into longer runs first.
+ */
+#ifndef SORT_EXTERNAL_H
+#define SORT_EXTERNAL_H
+
+#include <stddef.h>
+
+//Smallest block read from a run at a time; with the memory budget it sets the fan-in
+#define EXTERNAL_MIN_BLOCK_BYTES (1 << 20)
+
+typedef struct {
+    unsigned long long bytes;   //size of the input
+    int numRuns;
+    int mergePasses;            //passes over the data after run formation
+    double runSeconds;          //reading, sorting and writing the runs
+    double mergeSeconds;
+} externalSortStats;
+
+//Sort the ints of input into output, using about memoryBytes of memory and
+//numThreads threads to sort each run (counting/radix sort if useRadix). Run files
+//are written next to output as output.runP.I and removed afterwards.
+//memoryBytes must hold at least four blocks of EXTERNAL_MIN_BLOCK_BYTES. Returns 0 on
+//success, -1 on an I/O error, a bad input size or too little memory (errno tells which).
+int externalSortInts(const char *input, const char *output, size_t memoryBytes, int numThreads, int useRadix,
+                     externalSortStats *stats);
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ * Loser tree merge: leaves k..2k-1 are the runs, node i plays the winners of 2i and 2i+1.
+ */
+#include "sort_kway.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+//Key of an exhausted run, above every int
+#define RUN_DONE LLONG_MAX
+
+//Function Declarations
+static inline int beats(const long long *keys, int a, int b);
+
+//Run a wins against run b: smaller key, or the same key from an earlier run
+static inline int beats(const long long *keys, int a, int b)
+{
+    return keys[a] < keys[b] || (keys[a] == keys[b] && a < b);
+}
+
+int kwayMergeInts(int *out, const int *data, const size_t *bounds, int k)
+{
+    if (k <= 0)
+        return 0;
+    const int **runs = (const int**)malloc((size_t)k * sizeof(const int*));
+    size_t *lengths = (size_t*)malloc((size_t)k * sizeof(size_t));
+    int result = -1;
+    if (runs != NULL && lengths != NULL) {
+        for (int r = 0; r < k; r++) {
+            runs[r] = data + bounds[r];
+            lengths[r] = bounds[r + 1] - bounds[r];
+        }
+        result = kwayMergeRunsInts(out, runs, lengths, k);
+    }
+    free(runs);
+    free(lengths);
+    return result;
+}
+
+int kwayMergeRunsInts(int *out, const int *const *runs, const size_t *lengths, int k)
+{
+    if (k <= 0)
+        return 0;
+    if (k == 1) {
+        memcpy(out, runs[0], lengths[0] * sizeof(int));
+        return 0;
+    }
+
+    //losers[0] is the overall winner and losers[1..k-1] the internal nodes. winners
+    //is only used while building. next tracks each run's unread part.
+    int *losers = (int*)malloc(3 * (size_t)k * sizeof(int));
+    long long *keys = (long long*)malloc((size_t)k * sizeof(long long));
+    size_t *next = (size_t*)malloc((size_t)k * sizeof(size_t));
+    if (losers == NULL || keys == NULL || next == NULL) {
+        free(losers);
+        free(keys);
+        free(next);
+        return -1;
+    }
+    int *winners = losers + k;
+    size_t total = 0;
+    for (int r = 0; r < k; r++) {
+        next[r] = 0;
+        keys[r] = lengths[r] > 0 ? runs[r][0] : RUN_DONE;
+        winners[k + r] = r;
+        total += lengths[r];
+    }
+
+    //Play every game once, bottom up
+    for (int node = k - 1; node >= 1; node--) {
+        int a = winners[2 * node], b = winners[2 * node + 1];
+        if (beats(keys, a, b)) {
+            winners[node] = a;
+            losers[node] = b;
+        } else {
+            winners[node] = b;
+            losers[node] = a;
+        }
+    }
+    losers[0] = winners[1];
+
+    //Output the winner, refill its leaf and replay only the games on its path
+    for (size_t i = 0; i < total; i++) {
+        int w = losers[0];
+        out[i] = (int)keys[w];
+        next[w]++;
+        keys[w] = next[w] < lengths[w] ? runs[w][next[w]] : RUN_DONE;
+        for (int node = (w + k) / 2; node > 0; node /= 2) {
+            if (beats(keys, losers[node], w)) {
+                int t = losers[node];
+                losers[node] = w;
+                w = t;
+            }
+        }
+        losers[0] = w;
+    }
+
+    free(losers);
+    free(keys);
+    free(next);
+    return 0;
+}
@@ -0,0 +1,23 @@
+/*
+ * k-way merge of sorted runs with a loser tree.
+ *
+ * The k runs sit one after another in one array. Each internal node of the tree
+ * keeps the run that lost the game played there, and the overall winner sits above
+ * the root. Taking the smallest key only replays the games on the path from the
+ * winner's leaf, so every output key costs about log2(k) comparisons. All k runs
+ * are merged in one pass into a single output array, instead of log2(k) rounds of
+ * pairwise merges that each copy everything again.
+ */
+#ifndef SORT_KWAY_H
+#define SORT_KWAY_H
+
+#include <stddef.h>
+
+//Merge the k sorted runs data[bounds[r], bounds[r + 1]) for r < k into out, which
+//must hold bounds[k] - bounds[0] ints and not overlap data. Ties take from the
+//lower run. Returns 0 on success, -1 if the tree cannot be allocated.
+int kwayMergeInts(int *out, const int *data, const size_t *bounds, int k);
+//Same for k runs anywhere in memory: runs[r][0, lengths[r]). out must not overlap any.
+int kwayMergeRunsInts(int *out, const int *const *runs, const size_t *lengths, int k);
+
+#endif
@@ -0,0 +1,72 @@
+/*
+ * Bottom-up mergesort that ping-pongs between the data and one buffer.
+ */
+#include "sort_merge.h"
+#include <stdlib.h>
+#include <string.h>
+
+int mergeSortInts(int *data, size_t n)
+{
+    if (n <= SORT_INSERTION_RUN) {
+        insertionSortInts(data, n);
+        return 0;
+    }
+    int *buffer = (int*)malloc(n * sizeof(int));
+    if (buffer == NULL)
+        return -1;
+    mergeSortIntsWithBuffer(data, buffer, n);
+    free(buffer);
+    return 0;
+}
+
+void mergeSortIntsWithBuffer(int *data, int *buffer, size_t n)
+{
+    for (size_t lo = 0; lo < n; lo += SORT_INSERTION_RUN)
+        insertionSortInts(data + lo, n - lo < SORT_INSERTION_RUN ? n - lo : SORT_INSERTION_RUN);
+
+    //Each pass merges neighbouring runs of width elements from src into dst
+    int *src = data, *dst = buffer;
+    for (size_t width = SORT_INSERTION_RUN; width < n; width *= 2) {
+        for (size_t lo = 0; lo < n; lo += 2 * width) {
+            size_t mid = n - lo < width ? n : lo + width;
+            size_t hi = n - mid < width ? n : mid + width;
+            //Runs already in order, such as a lone last run, are only copied
+            if (mid == hi || src[mid - 1] <= src[mid])
+                memcpy(dst + lo, src + lo, (hi - lo) * sizeof(int));
+            else
+                mergeInts(dst + lo, src + lo, mid - lo, src + mid, hi - mid);
+        }
+        int *t = src;
+        src = dst;
+        dst = t;
+    }
+    if (src != data)
+        memcpy(data, src, n * sizeof(int));
+}
+
+void mergeInts(int *out, const int *a, size_t na, const int *b, size_t nb)
+{
+    size_t i = 0, j = 0, k = 0;
+    //Choosing without a branch keeps random keys from stalling on mispredictions
+    while (i < na && j < nb) {
+        int takeB = b[j] < a[i];
+        out[k++] = takeB ? b[j] : a[i];
+        j += takeB;
+        i += !takeB;
+    }
+    memcpy(out + k, a + i, (na - i) * sizeof(int));
+    memcpy(out + k + (na - i), b + j, (nb - j) * sizeof(int));
+}
+
+void insertionSortInts(int *data, size_t n)
+{
+    for (size_t i = 1; i < n; i++) {
+        int value = data[i];
+        size_t j = i;
+        while (j > 0 && data[j - 1] > value) {
+            data[j] = data[j - 1];
+            j--;
+        }
+        data[j] = value;
+    }
+}
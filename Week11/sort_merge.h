@@ -0,0 +1,26 @@
+/*
+ * Bottom-up mergesort of ints with a single auxiliary buffer.
+ *
+ * Runs of SORT_INSERTION_RUN elements are insertion sorted in place first. Runs are
+ * then merged pairwise, one level per pass, writing from data into the buffer and
+ * back again, so a pass reads and writes each element exactly once and nothing is
+ * allocated after the buffer. The sort is stable.
+ */
+#ifndef SORT_MERGE_H
+#define SORT_MERGE_H
+
+#include <stddef.h>
+
+//Runs short enough that insertion sort beats merging
+#define SORT_INSERTION_RUN 32
+
+//Sort data[0, n). Returns 0 on success, -1 if the buffer cannot be allocated
+int mergeSortInts(int *data, size_t n);
+//Same, with a caller's buffer of n ints as scratch space. The result is in data.
+void mergeSortIntsWithBuffer(int *data, int *buffer, size_t n);
+
+//Merge sorted a and b into out, which must not overlap either; ties take from a
+void mergeInts(int *out, const int *a, size_t na, const int *b, size_t nb);
+void insertionSortInts(int *data, size_t n);
+
+#endif
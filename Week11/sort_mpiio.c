@@ -0,0 +1,88 @@
+/*
+ * Collective sorted output: MPI_Exscan offsets and rounds of MPI_File_write_at_all.
+ */
+#include "sort_mpiio.h"
+#include <stdlib.h>
+
+//Longest text of one number: newline, sign, ten digits and a tab
+#define MAX_NUMBER_TEXT 13
+//Numbers formatted per collective write, keeping each write to a few MiB
+#define NUMBERS_PER_ROUND ((4 << 20) / MAX_NUMBER_TEXT)
+
+//Function Declarations
+static size_t formatNumber(char *out, int value, unsigned long long index);
+
+//Text of the number at global index, as written by the tree sort
+static size_t formatNumber(char *out, int value, unsigned long long index)
+{
+    char digits[12];
+    size_t len = 0, numDigits = 0;
+    if (index % 10 == 0)
+        out[len++] = '\n';
+    unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+    if (value < 0)
+        out[len++] = '-';
+    do {
+        digits[numDigits++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    while (numDigits > 0)
+        out[len++] = digits[--numDigits];
+    out[len++] = '\t';
+    return len;
+}
+
+int sortedWriteMPI(MPI_Comm comm, const char *filename, const int *data, size_t n)
+{
+    char *buf = (char*)malloc((size_t)NUMBERS_PER_ROUND * MAX_NUMBER_TEXT);
+
+    //Global index of the first number, then the length of this process's text
+    unsigned long long myCount = n, first = 0;
+    MPI_Exscan(&myCount, &first, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, comm);
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    if (rank == 0)
+        first = 0;
+    unsigned long long myBytes = 0, offset = 0;
+    char scratch[MAX_NUMBER_TEXT];
+    for (size_t i = 0; i < n; i++)
+        myBytes += formatNumber(scratch, data[i], first + i);
+    MPI_Exscan(&myBytes, &offset, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, comm);
+    if (rank == 0)
+        offset = 0;
+
+    MPI_File fh;
+    int failed = buf == NULL;
+    int opened = MPI_File_open(comm, filename, MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh) == MPI_SUCCESS;
+    failed |= !opened;
+    int anyFailed;
+    MPI_Allreduce(&failed, &anyFailed, 1, MPI_INT, MPI_LOR, comm);
+    if (anyFailed) {
+        if (opened)
+            MPI_File_close(&fh);
+        free(buf);
+        return -1;
+    }
+    //Drop anything an older, longer file left behind
+    MPI_File_set_size(fh, 0);
+
+    //Every process joins every collective write, so all run as many rounds as the
+    //process with the most numbers
+    unsigned long long myRounds = (n + NUMBERS_PER_ROUND - 1) / NUMBERS_PER_ROUND, rounds;
+    MPI_Allreduce(&myRounds, &rounds, 1, MPI_UNSIGNED_LONG_LONG, MPI_MAX, comm);
+    size_t i = 0;
+    for (unsigned long long round = 0; round < rounds; round++) {
+        size_t len = 0;
+        size_t end = n - i < NUMBERS_PER_ROUND ? n : i + NUMBERS_PER_ROUND;
+        for (; i < end; i++)
+            len += formatNumber(buf + len, data[i], first + i);
+        if (MPI_File_write_at_all(fh, (MPI_Offset)offset, buf, (int)len, MPI_CHAR, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+            failed = 1;
+        offset += len;
+    }
+    free(buf);
+
+    MPI_File_close(&fh);
+    MPI_Allreduce(&failed, &anyFailed, 1, MPI_INT, MPI_LOR, comm);
+    return anyFailed ? -1 : 0;
+}
@@ -0,0 +1,20 @@
+/*
+ * One sorted output file written by every process at once with MPI-IO.
+ *
+ * Each process holds the next part of the sorted data in rank order. MPI_Exscan of
+ * the element counts gives each its first global index, and of the byte counts
+ * where its text starts, so the file matches what a single writer would produce
+ * without gathering anything to the root.
+ */
+#ifndef SORT_MPIIO_H
+#define SORT_MPIIO_H
+
+#include <stddef.h>
+#include <mpi.h>
+
+//Write every process's data to filename, replacing it, in the layout of the tree
+//sort: "%d\t" per number with a newline before every tenth. Collective over comm.
+//Returns 0 on success, -1 if any process failed to open or write.
+int sortedWriteMPI(MPI_Comm comm, const char *filename, const int *data, size_t n);
+
+#endif
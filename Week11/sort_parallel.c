@@ -0,0 +1,126 @@
+/*
+ * Fork-join mergesort on pthreads; merges are split among threads by merge path.
+ */
+#include "sort_parallel.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "sort_merge.h"
+
+#define MAX_SORT_THREADS 256
+
+typedef struct {
+    int *data, *buffer;
+    size_t n;
+    int numThreads;
+    int intoBuffer;     //leave the result in buffer rather than data
+} sortTask;
+
+typedef struct {
+    int *out;
+    const int *a, *b;
+    size_t na, nb;
+    size_t lo, hi;      //output range [lo, hi) this thread writes
+} mergeTask;
+
+//Function Declarations
+static size_t mergePath(const int *a, size_t na, const int *b, size_t nb, size_t diag);
+static void *mergeThreadFunc(void *pArg);
+static void *sortThreadFunc(void *pArg);
+
+//How many of the first diag outputs come from a
+static size_t mergePath(const int *a, size_t na, const int *b, size_t nb, size_t diag)
+{
+    size_t lo = diag > nb ? diag - nb : 0;
+    size_t hi = diag < na ? diag : na;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        //a[mid] precedes b[diag - mid - 1] (ties take from a), so more of a fits
+        if (a[mid] <= b[diag - mid - 1])
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+static void *mergeThreadFunc(void *pArg)
+{
+    mergeTask *task = (mergeTask*)pArg;
+    size_t i0 = mergePath(task->a, task->na, task->b, task->nb, task->lo);
+    size_t i1 = mergePath(task->a, task->na, task->b, task->nb, task->hi);
+    size_t j0 = task->lo - i0, j1 = task->hi - i1;
+    mergeInts(task->out + task->lo, task->a + i0, i1 - i0, task->b + j0, j1 - j0);
+    return NULL;
+}
+
+void parallelMergeInts(int *out, const int *a, size_t na, const int *b, size_t nb, int numThreads)
+{
+    size_t total = na + nb;
+    if (numThreads > MAX_SORT_THREADS)
+        numThreads = MAX_SORT_THREADS;
+    if (numThreads <= 1 || total < PARALLEL_SORT_MIN_ELEMENTS) {
+        mergeInts(out, a, na, b, nb);
+        return;
+    }
+
+    pthread_t tid[MAX_SORT_THREADS];
+    mergeTask tasks[MAX_SORT_THREADS];
+    for (int i = 0; i < numThreads; i++) {
+        tasks[i].out = out;
+        tasks[i].a = a;
+        tasks[i].b = b;
+        tasks[i].na = na;
+        tasks[i].nb = nb;
+        tasks[i].lo = total * i / numThreads;
+        tasks[i].hi = total * (i + 1) / numThreads;
+    }
+    for (int i = 1; i < numThreads; i++)
+        pthread_create(&tid[i], NULL, mergeThreadFunc, &tasks[i]);
+    mergeThreadFunc(&tasks[0]);
+    for (int i = 1; i < numThreads; i++)
+        pthread_join(tid[i], NULL);
+}
+
+static void *sortThreadFunc(void *pArg)
+{
+    sortTask *task = (sortTask*)pArg;
+    size_t n = task->n;
+    if (task->numThreads <= 1 || n < PARALLEL_SORT_MIN_ELEMENTS) {
+        mergeSortIntsWithBuffer(task->data, task->buffer, n);
+        if (task->intoBuffer)
+            memcpy(task->buffer, task->data, n * sizeof(int));
+        return NULL;
+    }
+
+    //Fork: the left half on a new thread, the right half here; both land in the other array
+    size_t half = n / 2;
+    int leftThreads = task->numThreads / 2;
+    sortTask left = {task->data, task->buffer, half, leftThreads, !task->intoBuffer};
+    sortTask right = {task->data + half, task->buffer + half, n - half, task->numThreads - leftThreads, !task->intoBuffer};
+    pthread_t tid;
+    pthread_create(&tid, NULL, sortThreadFunc, &left);
+    sortThreadFunc(&right);
+    pthread_join(tid, NULL);
+
+    //Join: merge the halves back with every thread of this call
+    const int *src = task->intoBuffer ? task->data : task->buffer;
+    int *dst = task->intoBuffer ? task->buffer : task->data;
+    parallelMergeInts(dst, src, half, src + half, n - half, task->numThreads);
+    return NULL;
+}
+
+int parallelMergeSortInts(int *data, size_t n, int numThreads)
+{
+    if (numThreads > MAX_SORT_THREADS)
+        numThreads = MAX_SORT_THREADS;
+    if (numThreads <= 1)
+        return mergeSortInts(data, n);
+    int *buffer = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+    if (buffer == NULL)
+        return -1;
+    sortTask task = {data, buffer, n, numThreads, 0};
+    sortThreadFunc(&task);
+    free(buffer);
+    return 0;
+}
@@ -0,0 +1,31 @@
+/*
+ * Fork-join threaded mergesort with merge-path parallel merges.
+ *
+ * A call with T threads hands the left half to a new thread with T/2 threads and
+ * sorts the right half itself with the rest, until one thread is left, which runs
+ * the bottom-up mergesort of sort_merge.c. The halves land in the data or the
+ * buffer alternately by depth, so each level merges from one array into the other.
+ *
+ * The merge of two halves uses all T threads of the call. Merge path: output
+ * position d of merging a and b comes from the first i elements of a and d - i of b,
+ * where i is found by binary search along the diagonal i + j = d. Cutting the output
+ * into T equal ranges this way gives every thread an independent merge of equal
+ * size, so the top-level merges are no longer a serial bottleneck.
+ */
+#ifndef SORT_PARALLEL_H
+#define SORT_PARALLEL_H
+
+#include <stddef.h>
+
+//Below this many elements a call sorts or merges on one thread
+#define PARALLEL_SORT_MIN_ELEMENTS 65536
+
+//Sort data[0, n) with numThreads threads. Returns 0 on success, -1 if the buffer
+//cannot be allocated.
+int parallelMergeSortInts(int *data, size_t n, int numThreads);
+
+//Merge sorted a and b into out (which overlaps neither) with numThreads threads;
+//ties take from a
+void parallelMergeInts(int *out, const int *a, size_t na, const int *b, size_t nb, int numThreads);
+
+#endif
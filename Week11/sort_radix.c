@@ -0,0 +1,189 @@
+/*
+ * Counting sort for narrow key ranges, threaded LSD radix sort for the rest.
+ */
+#include "sort_radix.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#define MAX_RADIX_THREADS 256
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+
+typedef struct {
+    int *data, *buffer;
+    size_t n;
+    int numThreads;
+    int min;                    //keys are sorted as key - min
+    uint32_t span;              //largest key - min
+    size_t *counts;             //numThreads histograms, each of up to COUNTING_SORT_MAX_RANGE buckets
+    size_t *starts;             //counting sort: first output index of each value
+    int skipPass;               //radix sort: every key has the same digit this pass
+    pthread_barrier_t barrier;
+} radixState;
+
+typedef struct {
+    radixState *s;
+    int rank;
+} radixTask;
+
+//Function Declarations
+static void countingFill(radixState *s, int rank, size_t range);
+static void radixPasses(radixState *s, int rank);
+static void *radixThreadFunc(void *pArg);
+
+//Thread rank writes output [lo, hi), starting from the value that covers index lo
+static void countingFill(radixState *s, int rank, size_t range)
+{
+    size_t T = (size_t)s->numThreads, t = (size_t)rank;
+    size_t lo = s->n * t / T, hi = s->n * (t + 1) / T;
+    size_t first = 0, last = range;
+    while (first < last) {
+        size_t mid = first + (last - first) / 2;
+        if (s->starts[mid + 1] <= lo)
+            first = mid + 1;
+        else
+            last = mid;
+    }
+    for (size_t v = first; lo < hi; v++) {
+        size_t end = s->starts[v + 1] < hi ? s->starts[v + 1] : hi;
+        int value = (int)((int64_t)s->min + (int64_t)v);
+        while (lo < end)
+            s->data[lo++] = value;
+    }
+}
+
+static void radixPasses(radixState *s, int rank)
+{
+    uint32_t min = (uint32_t)s->min;
+    size_t T = (size_t)s->numThreads, t = (size_t)rank;
+    size_t lo = s->n * t / T, hi = s->n * (t + 1) / T;
+    size_t *mine = s->counts + t * RADIX_BUCKETS;
+    int *src = s->data, *dst = s->buffer;
+
+    for (int shift = 0; shift < 32 && (s->span >> shift) > 0; shift += RADIX_BITS) {
+        memset(mine, 0, RADIX_BUCKETS * sizeof(size_t));
+        for (size_t i = lo; i < hi; i++)
+            mine[(((uint32_t)src[i] - min) >> shift) & (RADIX_BUCKETS - 1)]++;
+        pthread_barrier_wait(&s->barrier);
+
+        //Histograms become each thread's first output index for every digit
+        if (rank == 0) {
+            size_t offset = 0;
+            s->skipPass = 0;
+            for (int d = 0; d < RADIX_BUCKETS; d++) {
+                size_t total = 0;
+                for (size_t k = 0; k < T; k++) {
+                    size_t c = s->counts[k * RADIX_BUCKETS + d];
+                    s->counts[k * RADIX_BUCKETS + d] = offset;
+                    offset += c;
+                    total += c;
+                }
+                if (total == s->n)
+                    s->skipPass = 1;
+            }
+        }
+        pthread_barrier_wait(&s->barrier);
+        if (s->skipPass)
+            continue;
+
+        for (size_t i = lo; i < hi; i++)
+            dst[mine[(((uint32_t)src[i] - min) >> shift) & (RADIX_BUCKETS - 1)]++] = src[i];
+        pthread_barrier_wait(&s->barrier);
+        int *swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != s->data)
+        memcpy(s->data + lo, src + lo, (hi - lo) * sizeof(int));
+}
+
+static void *radixThreadFunc(void *pArg)
+{
+    radixTask *task = (radixTask*)pArg;
+    radixState *s = task->s;
+    size_t T = (size_t)s->numThreads, t = (size_t)task->rank;
+    size_t lo = s->n * t / T, hi = s->n * (t + 1) / T;
+
+    if (s->buffer != NULL) {
+        radixPasses(s, task->rank);
+        return NULL;
+    }
+
+    size_t range = (size_t)s->span + 1;
+    size_t *mine = s->counts + t * range;
+    memset(mine, 0, range * sizeof(size_t));
+    for (size_t i = lo; i < hi; i++)
+        mine[(uint32_t)s->data[i] - (uint32_t)s->min]++;
+    pthread_barrier_wait(&s->barrier);
+    if (t == 0) {
+        s->starts[0] = 0;
+        for (size_t v = 0; v < range; v++) {
+            size_t total = 0;
+            for (size_t k = 0; k < T; k++)
+                total += s->counts[k * range + v];
+            s->starts[v + 1] = s->starts[v] + total;
+        }
+    }
+    pthread_barrier_wait(&s->barrier);
+    countingFill(s, task->rank, range);
+    return NULL;
+}
+
+int radixSortInts(int *data, size_t n, int numThreads)
+{
+    if (n < 2)
+        return 0;
+    if (numThreads > MAX_RADIX_THREADS)
+        numThreads = MAX_RADIX_THREADS;
+    if (numThreads < 1)
+        numThreads = 1;
+    if ((size_t)numThreads > n)
+        numThreads = (int)n;
+
+    //The range decides the method and the buffers, so it is found before any thread starts
+    int min = data[0], max = data[0];
+    for (size_t i = 1; i < n; i++) {
+        if (data[i] < min)
+            min = data[i];
+        if (data[i] > max)
+            max = data[i];
+    }
+    size_t range = (size_t)((uint32_t)max - (uint32_t)min) + 1;
+    int counting = range <= COUNTING_SORT_MAX_RANGE && range <= n;
+
+    radixState s;
+    s.data = data;
+    s.n = n;
+    s.numThreads = numThreads;
+    s.min = min;
+    s.span = (uint32_t)max - (uint32_t)min;
+    s.buffer = counting ? NULL : (int*)malloc(n * sizeof(int));
+    s.counts = (size_t*)malloc((size_t)numThreads * (counting ? range : RADIX_BUCKETS) * sizeof(size_t));
+    s.starts = counting ? (size_t*)malloc((range + 1) * sizeof(size_t)) : NULL;
+    if ((!counting && s.buffer == NULL) || s.counts == NULL || (counting && s.starts == NULL)) {
+        free(s.buffer);
+        free(s.counts);
+        free(s.starts);
+        return -1;
+    }
+
+    pthread_t tid[MAX_RADIX_THREADS];
+    radixTask tasks[MAX_RADIX_THREADS];
+    pthread_barrier_init(&s.barrier, NULL, numThreads);
+    for (int i = 0; i < numThreads; i++) {
+        tasks[i].s = &s;
+        tasks[i].rank = i;
+    }
+    for (int i = 1; i < numThreads; i++)
+        pthread_create(&tid[i], NULL, radixThreadFunc, &tasks[i]);
+    radixThreadFunc(&tasks[0]);
+    for (int i = 1; i < numThreads; i++)
+        pthread_join(tid[i], NULL);
+    pthread_barrier_destroy(&s.barrier);
+
+    free(s.buffer);
+    free(s.counts);
+    free(s.starts);
+    return 0;
+}
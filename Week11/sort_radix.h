@@ -0,0 +1,26 @@
+/*
+ * Integer sorting that looks at the key range first.
+ *
+ * One pass finds the smallest and largest key. When they span no more than
+ * COUNTING_SORT_MAX_RANGE values (and no more values than there are keys), a
+ * counting sort histograms the keys and writes each value back out as often as it
+ * occurred, with no buffer. Otherwise an LSD radix sort orders key - min by
+ * RADIX_BITS bits per pass, runs only as many passes as the range needs, and skips
+ * passes in which every key has the same digit.
+ *
+ * Each thread histograms its own block of the keys. Offsets are then laid out digit
+ * by digit and, within a digit, thread by thread, so every thread scatters its block
+ * without locks and the sort is stable.
+ */
+#ifndef SORT_RADIX_H
+#define SORT_RADIX_H
+
+#include <stddef.h>
+
+#define COUNTING_SORT_MAX_RANGE (1 << 16)
+#define RADIX_BITS 8
+
+//Sort data[0, n) with numThreads threads. Returns 0 on success, -1 if memory runs out
+int radixSortInts(int *data, size_t n, int numThreads);
+
+#endif
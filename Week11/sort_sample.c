@@ -0,0 +1,134 @@
+/*
+ * PSRS: regular samples, all-gathered splitters, one MPI_Alltoallv, one k-way merge.
+ */
+#include "sort_sample.h"
+#include <stdlib.h>
+#include <string.h>
+#include "sort_kway.h"
+
+//A key with its global position, which makes every key distinct
+typedef struct {
+    long long key;
+    long long position;
+} sortSample;
+
+//Function Declarations
+static int sampleCompare(const void *a, const void *b);
+static size_t lowerBound(const int *sorted, size_t n, unsigned long long offset, const sortSample *s);
+
+static int sampleCompare(const void *a, const void *b)
+{
+    const sortSample *x = (const sortSample*)a, *y = (const sortSample*)b;
+    if (x->key != y->key)
+        return x->key < y->key ? -1 : 1;
+    return (x->position > y->position) - (x->position < y->position);
+}
+
+//First index of the block whose (key, position) is not below s
+static size_t lowerBound(const int *sorted, size_t n, unsigned long long offset, const sortSample *s)
+{
+    size_t lo = 0, hi = n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (sorted[mid] < s->key || (sorted[mid] == s->key && (long long)(offset + mid) < s->position))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+int sampleSortInts(MPI_Comm comm, const int *sorted, size_t n, int **out, size_t *outN, sampleSortTimes *times)
+{
+    int rank, p;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &p);
+    double t0 = MPI_Wtime();
+
+    //Position of this block's first key in the whole data
+    unsigned long long myCount = n, offset = 0;
+    MPI_Exscan(&myCount, &offset, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, comm);
+    if (rank == 0)
+        offset = 0;
+
+    //p evenly spaced samples per block. An empty block offers samples above every key,
+    //which only ever become splitters that nothing is cut at.
+    sortSample *samples = (sortSample*)malloc((size_t)p * p * sizeof(sortSample));
+    int *sendCounts = (int*)malloc(4 * (size_t)p * sizeof(int));
+    size_t *bounds = (size_t*)malloc(((size_t)p + 1) * sizeof(size_t));
+    int failed = samples == NULL || sendCounts == NULL || bounds == NULL;
+    int anyFailed;
+    MPI_Allreduce(&failed, &anyFailed, 1, MPI_INT, MPI_LOR, comm);
+    if (anyFailed) {
+        free(samples);
+        free(sendCounts);
+        free(bounds);
+        return -1;
+    }
+    int *sendDispls = sendCounts + p, *recvCounts = sendCounts + 2 * p, *recvDispls = sendCounts + 3 * p;
+
+    sortSample mine[p];
+    for (int j = 0; j < p; j++) {
+        size_t index = n * j / p;
+        mine[j].key = n > 0 ? sorted[index] : (long long)1 << 62;
+        mine[j].position = (long long)(offset + index);
+    }
+    MPI_Allgather(mine, 2 * p, MPI_LONG_LONG, samples, 2 * p, MPI_LONG_LONG, comm);
+    qsort(samples, (size_t)p * p, sizeof(sortSample), sampleCompare);
+
+    //Splitter i - 1 starts piece i. Every process picks the same ones from the same samples.
+    bounds[0] = 0;
+    for (int i = 1; i < p; i++)
+        bounds[i] = lowerBound(sorted, n, offset, &samples[(size_t)i * p + p / 2 - 1]);
+    bounds[p] = n;
+    for (int i = 0; i < p; i++) {
+        sendCounts[i] = (int)(bounds[i + 1] - bounds[i]);
+        sendDispls[i] = (int)bounds[i];
+    }
+    free(samples);
+    double t1 = MPI_Wtime();
+
+    //Swap piece sizes, then the pieces
+    MPI_Alltoall(sendCounts, 1, MPI_INT, recvCounts, 1, MPI_INT, comm);
+    size_t total = 0;
+    for (int i = 0; i < p; i++) {
+        recvDispls[i] = (int)total;
+        bounds[i] = total;
+        total += recvCounts[i];
+    }
+    bounds[p] = total;
+    int *received = (int*)malloc((total > 0 ? total : 1) * sizeof(int));
+    int *buffer = (int*)malloc((total > 0 ? total : 1) * sizeof(int));
+    failed = received == NULL || buffer == NULL;
+    MPI_Allreduce(&failed, &anyFailed, 1, MPI_INT, MPI_LOR, comm);
+    if (anyFailed) {
+        free(received);
+        free(buffer);
+        free(sendCounts);
+        free(bounds);
+        return -1;
+    }
+    MPI_Alltoallv(sorted, sendCounts, sendDispls, MPI_INT, received, recvCounts, recvDispls, MPI_INT, comm);
+    double t2 = MPI_Wtime();
+
+    //The p pieces arrive sorted, so one k-way pass merges them
+    failed = kwayMergeInts(buffer, received, bounds, p) != 0;
+    free(received);
+    free(sendCounts);
+    free(bounds);
+    MPI_Allreduce(&failed, &anyFailed, 1, MPI_INT, MPI_LOR, comm);
+    if (anyFailed) {
+        free(buffer);
+        return -1;
+    }
+    *out = buffer;
+    *outN = total;
+    double t3 = MPI_Wtime();
+
+    if (times != NULL) {
+        times->splitters = t1 - t0;
+        times->exchange = t2 - t1;
+        times->merge = t3 - t2;
+    }
+    return 0;
+}
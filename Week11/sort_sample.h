@@ -0,0 +1,35 @@
+/*
+ * Parallel sample sort by regular sampling (PSRS).
+ *
+ * Every process starts with its own sorted block. Each takes p evenly spaced samples
+ * of its block, the p * p samples are all-gathered and sorted, and p - 1 splitters
+ * are picked at evenly spaced positions among them. Each process cuts its block at
+ * the splitters and sends piece i to process i with one MPI_Alltoallv, then merges
+ * the p sorted pieces it receives in one k-way pass. Afterwards process i holds the
+ * i-th part of the sorted data, and regular sampling keeps every part below about
+ * 2n/p elements.
+ *
+ * Keys are ordered together with their global position in the sorted blocks, so
+ * runs of equal keys can be split between processes. Without that, data with few
+ * distinct values (such as rand() % 100) would send each value to a single process.
+ */
+#ifndef SORT_SAMPLE_H
+#define SORT_SAMPLE_H
+
+#include <stddef.h>
+#include <mpi.h>
+
+//Seconds this process spent in each step
+typedef struct {
+    double splitters;   //sampling, choosing splitters and cutting the block
+    double exchange;    //MPI_Alltoallv of counts and pieces
+    double merge;       //merging the received pieces
+} sampleSortTimes;
+
+//Sample sort the sorted blocks of every process in comm. out receives a malloc'd
+//array of this process's part of the result and outN its length. Each process must
+//end up with fewer than 2^31 elements. Collective over comm.
+//Returns 0 on success, -1 if any process ran out of memory.
+int sampleSortInts(MPI_Comm comm, const int *sorted, size_t n, int **out, size_t *outN, sampleSortTimes *times);
+
+#endif
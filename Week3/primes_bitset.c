@@ -0,0 +1,150 @@
+/*
+ * Bit-packed odd-only prime set with a rank/select directory.
+ *
+ * The directory holds the number of members before every block of
+ * PRIME_SET_RANK_WORDS words. Rank adds at most that many popcounts to one
+ * entry, and select binary searches the entries and then walks one block.
+ */
+#include "primes_bitset.h"
+#include <stdlib.h>
+
+//Function Declarations
+static uint64_t bitIndex(const primeSet *s, uint64_t x);
+static unsigned selectInWord(uint64_t w, unsigned k);
+
+int primeSetInit(primeSet *s, uint64_t lo, uint64_t hi)
+{
+    //Keep 2 representable: a set reaching down to 2 starts at 0
+    s->lo = lo <= 2 ? 0 : lo & ~1ULL;
+    s->hi = hi > s->lo ? hi : s->lo;
+    s->numWords = ((s->hi - s->lo) / 2 + 63) / 64;
+    s->words = (uint64_t*)calloc(s->numWords > 0 ? s->numWords : 1, sizeof(uint64_t));
+    s->blockRank = NULL;
+    return s->words != NULL ? 0 : -1;
+}
+
+void primeSetFree(primeSet *s)
+{
+    free(s->words);
+    free(s->blockRank);
+    s->words = NULL;
+    s->blockRank = NULL;
+    s->numWords = 0;
+}
+
+//Index of the first bit that stands for a number >= x
+static uint64_t bitIndex(const primeSet *s, uint64_t x)
+{
+    if (x <= s->lo || (s->lo == 0 && x <= 2))
+        return 0;
+    return (x - s->lo) / 2;
+}
+
+uint64_t primeSetBitValue(const primeSet *s, uint64_t j)
+{
+    if (s->lo == 0 && j == 0)
+        return 2;
+    return s->lo + 2 * j + 1;
+}
+
+void primeSetAdd(primeSet *s, uint64_t x)
+{
+    uint64_t j = bitIndex(s, x);
+    s->words[j / 64] |= 1ULL << (j % 64);
+}
+
+int primeSetContains(const primeSet *s, uint64_t x)
+{
+    //Even numbers other than 2 have no bit, and 1 would alias 2's bit
+    if (x < s->lo || x >= s->hi || x == 1 || (x % 2 == 0 && !(x == 2 && s->lo == 0)))
+        return 0;
+    uint64_t j = bitIndex(s, x);
+    return (s->words[j / 64] >> (j % 64)) & 1;
+}
+
+uint64_t primeSetNext(const primeSet *s, uint64_t x)
+{
+    uint64_t j = bitIndex(s, x);
+    uint64_t w = j / 64;
+    if (w >= s->numWords)
+        return s->hi;
+    uint64_t bits = s->words[w] & (~0ULL << (j % 64));
+    while (bits == 0) {
+        if (++w == s->numWords)
+            return s->hi;
+        bits = s->words[w];
+    }
+    return primeSetBitValue(s, w * 64 + __builtin_ctzll(bits));
+}
+
+void primeSetBuildRank(primeSet *s)
+{
+    uint64_t numBlocks = s->numWords / PRIME_SET_RANK_WORDS + 1;
+    free(s->blockRank);
+    s->blockRank = (uint64_t*)malloc(numBlocks * sizeof(uint64_t));
+    uint64_t total = 0;
+    for (uint64_t b = 0; b < numBlocks; b++) {
+        s->blockRank[b] = total;
+        for (uint64_t w = b * PRIME_SET_RANK_WORDS; w < (b + 1) * PRIME_SET_RANK_WORDS && w < s->numWords; w++)
+            total += __builtin_popcountll(s->words[w]);
+    }
+}
+
+uint64_t primeSetRank(const primeSet *s, uint64_t x)
+{
+    uint64_t j = bitIndex(s, x);
+    if (j > s->numWords * 64)
+        j = s->numWords * 64;
+    uint64_t w = j / 64;
+    uint64_t count = s->blockRank[w / PRIME_SET_RANK_WORDS];
+    for (uint64_t i = w / PRIME_SET_RANK_WORDS * PRIME_SET_RANK_WORDS; i < w; i++)
+        count += __builtin_popcountll(s->words[i]);
+    if (j % 64)
+        count += __builtin_popcountll(s->words[w] & ((1ULL << (j % 64)) - 1));
+    return count;
+}
+
+//Position of the k-th set bit of w, counting from 0
+static unsigned selectInWord(uint64_t w, unsigned k)
+{
+    for (; k > 0; k--)
+        w &= w - 1;
+    return __builtin_ctzll(w);
+}
+
+uint64_t primeSetSelect(const primeSet *s, uint64_t k)
+{
+    //Last block that starts with at most k members before it
+    uint64_t low = 0, high = s->numWords / PRIME_SET_RANK_WORDS;
+    while (low < high) {
+        uint64_t mid = (low + high + 1) / 2;
+        if (s->blockRank[mid] <= k)
+            low = mid;
+        else
+            high = mid - 1;
+    }
+    uint64_t remaining = k - s->blockRank[low];
+    for (uint64_t w = low * PRIME_SET_RANK_WORDS; w < s->numWords; w++) {
+        uint64_t count = __builtin_popcountll(s->words[w]);
+        if (remaining < count)
+            return primeSetBitValue(s, w * 64 + selectInWord(s->words[w], (unsigned)remaining));
+        remaining -= count;
+    }
+    return s->hi;
+}
+
+uint64_t primeSetCount(const primeSet *s)
+{
+    uint64_t total = 0;
+    for (uint64_t w = 0; w < s->numWords; w++)
+        total += __builtin_popcountll(s->words[w]);
+    return total;
+}
+
+void primeSetWrite(FILE *fp, const primeSet *s)
+{
+    for (uint64_t w = 0; w < s->numWords; w++) {
+        for (uint64_t bits = s->words[w]; bits != 0; bits &= bits - 1)
+            fprintf(fp, "%llu\n", (unsigned long long)primeSetBitValue(s, w * 64 + __builtin_ctzll(bits)));
+    }
+}
@@ -0,0 +1,53 @@
+/*
+ * Bit-packed set of primes in a range [lo, hi).
+ *
+ * Only odd numbers get a bit: bit j stands for lo + 2j + 1, so one 64-bit word
+ * covers 128 numbers. That is 1/64 of the memory an int per number needs.
+ * When lo is 0, bit 0 would be the number 1, which is never prime, so it stands
+ * for 2 instead. Sets whose lo is a multiple of PRIME_SET_WORD_SPAN line up word
+ * for word with a set starting at 0, so their words can be copied straight into it.
+ */
+#ifndef PRIMES_BITSET_H
+#define PRIMES_BITSET_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+//Numbers covered by one word of bits
+#define PRIME_SET_WORD_SPAN 128
+//Words per entry of the rank directory
+#define PRIME_SET_RANK_WORDS 8
+
+typedef struct {
+    uint64_t lo, hi;        //lo is rounded down to an even number
+    uint64_t *words;
+    uint64_t numWords;
+    uint64_t *blockRank;    //Members before each block of words; NULL until primeSetBuildRank
+} primeSet;
+
+//Empty set over [lo, hi). Returns 0 on success, -1 if memory runs out
+int primeSetInit(primeSet *s, uint64_t lo, uint64_t hi);
+void primeSetFree(primeSet *s);
+
+//x must be 2 or odd and inside [lo, hi). Threads may add concurrently only if they
+//never touch the same word, e.g. each owns whole multiples of PRIME_SET_WORD_SPAN.
+void primeSetAdd(primeSet *s, uint64_t x);
+int primeSetContains(const primeSet *s, uint64_t x);
+
+//Smallest member >= x, or hi if there is none
+uint64_t primeSetNext(const primeSet *s, uint64_t x);
+//The number bit j stands for, for walking the words directly
+uint64_t primeSetBitValue(const primeSet *s, uint64_t j);
+
+//Rank and select need the directory, which must be rebuilt after adding members
+void primeSetBuildRank(primeSet *s);
+//Number of members below x
+uint64_t primeSetRank(const primeSet *s, uint64_t x);
+//The k-th smallest member counting from 0, or hi if there are not that many
+uint64_t primeSetSelect(const primeSet *s, uint64_t k);
+uint64_t primeSetCount(const primeSet *s);
+
+//One member per line in increasing order
+void primeSetWrite(FILE *fp, const primeSet *s);
+
+#endif
@@ -0,0 +1,194 @@
+/*
+ * Sublinear prime counting (Lucy's method), serial and threaded.
+ *
+ * small[v] holds S(v) for v <= r = sqrt(m) and large[i] holds S(m / i) for
+ * i <= r. Crossing off prime p changes only the values v >= p * p:
+ *     S(v) -= S(v / p) - S(p - 1)
+ * Serially, large is updated in increasing i and small in decreasing v, so
+ * every S(v / p) read is still the value from before p. The threads instead
+ * compute all of a prime's changes first and apply them after a barrier.
+ */
+#include "primes_count.h"
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+
+//Primes whose update touches fewer values than this per thread are not worth a barrier
+#define COUNT_PARALLEL_WORK 16384
+#define MAX_COUNT_THREADS 256
+
+typedef struct {
+    uint64_t m, r;
+    uint64_t *small;                //small[v] = S(v), 0 <= v <= r
+    uint64_t *large;                //large[i] = S(m / i), 1 <= i <= r
+    uint64_t *deltaSmall, *deltaLarge;
+    uint64_t heavyEnd;              //Primes below this are shared among the threads
+    int numThreads;
+    pthread_barrier_t barrier;
+} countState;
+
+typedef struct {
+    countState *c;
+    int rank;
+} countTask;
+
+//Function Declarations
+static uint64_t isqrt(uint64_t n);
+static inline uint64_t quotient(uint64_t a, uint64_t b);
+static uint64_t updateSize(const countState *c, uint64_t p);
+static void crossOff(countState *c, uint64_t p);
+static void *countThreadFunc(void *pArg);
+
+static uint64_t isqrt(uint64_t n)
+{
+    uint64_t r = (uint64_t)sqrt((double)n);
+    while (r * r > n)
+        r--;
+    while ((r + 1) * (r + 1) <= n)
+        r++;
+    return r;
+}
+
+//a / b through a double division, which is much faster than a 64-bit integer one.
+//a < 2^53, so the estimate is off by at most one and one check each way fixes it.
+static inline uint64_t quotient(uint64_t a, uint64_t b)
+{
+    uint64_t q = (uint64_t)((double)a / (double)b);
+    if (q * b > a)
+        q--;
+    else if ((q + 1) * b <= a)
+        q++;
+    return q;
+}
+
+//How many values crossing off p changes
+static uint64_t updateSize(const countState *c, uint64_t p)
+{
+    uint64_t numLarge = c->m / (p * p) < c->r ? c->m / (p * p) : c->r;
+    uint64_t numSmall = p * p <= c->r ? c->r - p * p + 1 : 0;
+    return numLarge + numSmall;
+}
+
+//Serial in-place update for prime p
+static void crossOff(countState *c, uint64_t p)
+{
+    uint64_t m = c->m, r = c->r, sp = c->small[p - 1];
+    uint64_t numLarge = m / (p * p) < r ? m / (p * p) : r;
+    for (uint64_t i = 1; i <= numLarge; i++) {
+        uint64_t d = i * p;
+        c->large[i] -= (d <= r ? c->large[d] : c->small[quotient(m, d)]) - sp;
+    }
+    for (uint64_t v = r; v >= p * p; v--)
+        c->small[v] -= c->small[quotient(v, p)] - sp;
+}
+
+//Every thread walks the same primes; each works out its share of a prime's changes,
+//then after a barrier applies them
+static void *countThreadFunc(void *pArg)
+{
+    countTask *task = (countTask*)pArg;
+    countState *c = task->c;
+    uint64_t m = c->m, r = c->r, T = (uint64_t)c->numThreads, t = (uint64_t)task->rank;
+
+    for (uint64_t p = 2; p < c->heavyEnd; p++) {
+        //small[p] is final once every prime below p is done
+        if (c->small[p] == c->small[p - 1])
+            continue;
+        uint64_t sp = c->small[p - 1];
+        uint64_t numLarge = m / (p * p) < r ? m / (p * p) : r;
+        uint64_t numSmall = p * p <= r ? r - p * p + 1 : 0;
+        uint64_t largeLo = 1 + numLarge * t / T, largeHi = 1 + numLarge * (t + 1) / T;
+        uint64_t smallLo = p * p + numSmall * t / T, smallHi = p * p + numSmall * (t + 1) / T;
+
+        for (uint64_t i = largeLo; i < largeHi; i++) {
+            uint64_t d = i * p;
+            c->deltaLarge[i] = (d <= r ? c->large[d] : c->small[quotient(m, d)]) - sp;
+        }
+        for (uint64_t v = smallLo; v < smallHi; v++)
+            c->deltaSmall[v] = c->small[quotient(v, p)] - sp;
+        pthread_barrier_wait(&c->barrier);
+
+        for (uint64_t i = largeLo; i < largeHi; i++)
+            c->large[i] -= c->deltaLarge[i];
+        for (uint64_t v = smallLo; v < smallHi; v++)
+            c->small[v] -= c->deltaSmall[v];
+        pthread_barrier_wait(&c->barrier);
+    }
+    return NULL;
+}
+
+uint64_t primeCount(uint64_t n)
+{
+    return primeCountParallel(n, 1);
+}
+
+uint64_t primeCountParallel(uint64_t n, int numThreads)
+{
+    if (n > PRIME_COUNT_MAX_LIMIT)
+        return UINT64_MAX;
+    if (n <= 2)
+        return 0;
+    if (numThreads > MAX_COUNT_THREADS)
+        numThreads = MAX_COUNT_THREADS;
+    if (numThreads < 1)
+        numThreads = 1;
+
+    //Count primes in [2, m]
+    countState c;
+    c.m = n - 1;
+    c.r = isqrt(c.m);
+    c.numThreads = numThreads;
+    c.small = (uint64_t*)malloc((c.r + 1) * sizeof(uint64_t));
+    c.large = (uint64_t*)malloc((c.r + 1) * sizeof(uint64_t));
+    c.deltaSmall = c.deltaLarge = NULL;
+    if (numThreads > 1) {
+        c.deltaSmall = (uint64_t*)malloc((c.r + 1) * sizeof(uint64_t));
+        c.deltaLarge = (uint64_t*)malloc((c.r + 1) * sizeof(uint64_t));
+    }
+    if (c.small == NULL || c.large == NULL || (numThreads > 1 && (c.deltaSmall == NULL || c.deltaLarge == NULL))) {
+        free(c.small);
+        free(c.large);
+        free(c.deltaSmall);
+        free(c.deltaLarge);
+        return UINT64_MAX;
+    }
+
+    //Nothing is crossed off yet: S(v) = v - 1
+    c.small[0] = 0;
+    for (uint64_t v = 1; v <= c.r; v++)
+        c.small[v] = v - 1;
+    for (uint64_t i = 1; i <= c.r; i++)
+        c.large[i] = c.m / i - 1;
+
+    //Updates shrink as p grows, so the threads share the first primes and the rest
+    //are done serially
+    c.heavyEnd = 2;
+    if (numThreads > 1) {
+        while (c.heavyEnd <= c.r && updateSize(&c, c.heavyEnd) >= COUNT_PARALLEL_WORK * (uint64_t)numThreads)
+            c.heavyEnd++;
+        pthread_t tid[MAX_COUNT_THREADS];
+        countTask tasks[MAX_COUNT_THREADS];
+        pthread_barrier_init(&c.barrier, NULL, numThreads);
+        for (int i = 0; i < numThreads; i++) {
+            tasks[i].c = &c;
+            tasks[i].rank = i;
+        }
+        for (int i = 1; i < numThreads; i++)
+            pthread_create(&tid[i], NULL, countThreadFunc, &tasks[i]);
+        countThreadFunc(&tasks[0]);
+        for (int i = 1; i < numThreads; i++)
+            pthread_join(tid[i], NULL);
+        pthread_barrier_destroy(&c.barrier);
+    }
+    for (uint64_t p = c.heavyEnd; p <= c.r; p++) {
+        if (c.small[p] != c.small[p - 1])
+            crossOff(&c, p);
+    }
+
+    uint64_t count = c.large[1];
+    free(c.small);
+    free(c.large);
+    free(c.deltaSmall);
+    free(c.deltaLarge);
+    return count;
+}
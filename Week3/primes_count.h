@@ -0,0 +1,24 @@
+/*
+ * Counting primes without listing them.
+ *
+ * Lucy's dynamic programming form of Legendre's method keeps S(v), the count of
+ * numbers in [2, v] not yet crossed off, for every distinct value v = m / i.
+ * There are only about 2 * sqrt(m) of those. Crossing off the multiples of each
+ * prime p <= sqrt(m) updates them in place; at the end S(m) is the prime count.
+ * This takes about m^(3/4) / log m steps and 32 * sqrt(m) bytes, instead of
+ * sieving all of [0, m].
+ */
+#ifndef PRIMES_COUNT_H
+#define PRIMES_COUNT_H
+
+#include <stdint.h>
+
+//Largest supported n; memory grows with sqrt(n) (about 1 GiB here with threads)
+#define PRIME_COUNT_MAX_LIMIT 1000000000000000ULL
+
+//Number of primes less than n, or UINT64_MAX if n is too large or memory runs out
+uint64_t primeCount(uint64_t n);
+//Same, sharing the work of the smallest primes (most of the total) among numThreads threads
+uint64_t primeCountParallel(uint64_t n, int numThreads);
+
+#endif
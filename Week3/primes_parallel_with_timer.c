@@ -3,19 +3,70 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <pthread.h> 
-
-#define NUM_THREADS 50
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <stdatomic.h>
+#include "primes_sieve.h"
+#include "primes_bitset.h"
+#include "primes_writer.h"
+#include "primes_count.h"
+#include "primes_primality.h"
+
+#define MAX_THREADS 1024
+//Numbers handed to a thread at a time by the trial method; a multiple of
+//PRIME_SET_WORD_SPAN so no two threads ever set bits in the same word
+#define CHUNK_SIZE 4096
 
 //Global Variables
-int n;
-int *primesArray= NULL;
+long long n;
+primeSet primes;
+int numThreads;
+
+//The trial method hands out chunks from a shared counter, so fast threads take more of them
+atomic_llong nextChunk = 0;
+//Per-thread CPU time spent working (not waiting or preempted) and chunks or segments done
+double busyTime[MAX_THREADS];
+long long workDone[MAX_THREADS];
+
+//Sieve method state: segments go round-robin to the threads, which format their
+//segment's primes into text. Two sets of text buffers let a round be written while
+//the next one is being sieved.
+primeSieve sieve;
+char **sieveText[2];
+size_t *sieveTextLen[2];
+pthread_barrier_t roundBarrier;
+int sieveFd;
+off_t sieveStart, sieveEnd;
 
 //Function Declarrations
-bool isPrime(int n);
 void *ThreadFunc(void *pArg);
+void *SieveThreadFunc(void *pArg);
+double elapsedSeconds(struct timespec start, struct timespec end);
+
+
+// usage: primes_parallel_with_timer [-m sieve|trial|count] [-t THREADS]   (threads default to the online cores)
+// build: gcc primes_parallel_with_timer.c primes_sieve.c primes_bitset.c primes_primality.c primes_writer.c primes_count.c -lm -lpthread
+int main(int argc, char *argv[]){
+    // Pick the method (segmented sieve by default, or only count the primes) and the number of threads
+    bool useSieve = true, useCount = false;
+    numThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    for (int i = 1; i < argc; i += 2){
+        if (i + 1 < argc && strcmp(argv[i], "-m") == 0 && (strcmp(argv[i + 1], "sieve") == 0 || strcmp(argv[i + 1], "trial") == 0 || strcmp(argv[i + 1], "count") == 0)){
+            useSieve = strcmp(argv[i + 1], "sieve") == 0;
+            useCount = strcmp(argv[i + 1], "count") == 0;
+        } else if (i + 1 < argc && strcmp(argv[i], "-t") == 0){
+            numThreads = atoi(argv[i + 1]);
+        } else {
+            numThreads = 0;
+            break;
+        }
+    }
+    if (numThreads < 1 || numThreads > MAX_THREADS){
+        printf("usage: %s [-m sieve|trial|count] [-t THREADS]\n", argv[0]);
+        return 1;
+    }
 
-
-int main(){
     // Initialise variables for timing program runtime
     clock_t start, end;
     double cpu_time_used;
@@ -26,40 +77,98 @@ int main(){
     
     // Read user input and store it in variable 'n'
     printf("Enter a number: ");
-    scanf("%d", &n);
+    scanf("%lld", &n);
 
     
-    //Allocate variables and memory for threads and primesArray
-    pthread_t tid[NUM_THREADS];
-	int threadNum[NUM_THREADS];
-    primesArray = (int*)malloc(n * sizeof(int));
-    printf("Number of threads: %d \n",NUM_THREADS);
+    //Allocate variables and memory for threads
+    pthread_t tid[MAX_THREADS];
+	int threadNum[MAX_THREADS];
+    printf("Number of threads: %d \n",numThreads);
     
+    if (useCount){
+        //Count without listing: no file is written
+        if (n > (long long)PRIME_COUNT_MAX_LIMIT){
+            printf("n is too large to count\n");
+            return 1;
+        }
+        printf("%llu primes less than %lld\n", (unsigned long long)primeCountParallel(n > 0 ? n : 0, numThreads), n);
+
+        // End timer and print duration
+        end = clock();
+        cpu_time_used = ((double) (end - start)) / CLOCKS_PER_SEC;
+        printf("This program took %f to execute\n", cpu_time_used);
+        return 0;
+    }
+
     // Create a file named "primes.txt"
     FILE *fp;
     fp = fopen("primes.txt", "w+");
-    fprintf(fp, "Prime Number less than %d:\n",n);
+    fprintf(fp, "Prime Number less than %lld:\n",n);
+
+    if (useSieve){
+        if (sieveInit(&sieve, n > 0 ? n : 0) != 0){
+            printf("n is too large for the sieve\n");
+            return 1;
+        }
+        //Threads pwrite their text after the header
+        fflush(fp);
+        sieveFd = fileno(fp);
+        sieveStart = ftello(fp);
+        for (int b = 0; b < 2; b++){
+            sieveText[b] = (char**)malloc(numThreads * sizeof(char*));
+            sieveTextLen[b] = (size_t*)malloc(numThreads * sizeof(size_t));
+            for (int i = 0; i < numThreads; i++)
+                sieveText[b][i] = (char*)malloc(SIEVE_SEGMENT_BYTES * WRITER_MAX_LINE);
+        }
+        pthread_barrier_init(&roundBarrier, NULL, numThreads);
+    } else {
+        if (primeSetInit(&primes, 0, n > 0 ? n : 0) != 0){
+            printf("Not enough memory for n = %lld\n", n);
+            return 1;
+        }
+    }
 
     // Fork		
-	for (int i = 0; i < NUM_THREADS; i++){
+	for (int i = 0; i < numThreads; i++){
 	    threadNum[i] = i;
-		pthread_create(&tid[i], 0, ThreadFunc, &threadNum[i]);
+		pthread_create(&tid[i], 0, useSieve ? SieveThreadFunc : ThreadFunc, &threadNum[i]);
 	}
 	
 	// Join
-	for(int i = 0; i < NUM_THREADS; i++){
+	for(int i = 0; i < numThreads; i++){
 	    	pthread_join(tid[i], NULL);
 	}
 
-    //Write prime numbers to file
-    for (int i=0; i<n; i++){
-        if (primesArray[i])
-            fprintf(fp, "%d\n", i);
+    //Report how evenly the work was spread
+    double maxBusy = 0, totalBusy = 0;
+    for (int i = 0; i < numThreads; i++){
+        printf("Thread %d: %lld %s, busy %f s\n", i, workDone[i], useSieve ? "segments" : "chunks", busyTime[i]);
+        totalBusy += busyTime[i];
+        if (busyTime[i] > maxBusy)
+            maxBusy = busyTime[i];
+    }
+    if (maxBusy > 0)
+        printf("Load balance (mean / max busy time): %f\n", totalBusy / numThreads / maxBusy);
+
+    if (useSieve){
+        //Primes were written by the threads as each round finished
+        fseeko(fp, sieveEnd, SEEK_SET);
+        pthread_barrier_destroy(&roundBarrier);
+        for (int b = 0; b < 2; b++){
+            for (int i = 0; i < numThreads; i++)
+                free(sieveText[b][i]);
+            free(sieveText[b]);
+            free(sieveTextLen[b]);
+        }
+        sieveFree(&sieve);
+    } else {
+        //Write prime numbers to file
+        primeSetWriteParallel(fp, &primes, numThreads);
+        primeSetFree(&primes);
     }
     //Close file and free allocated memory
     fclose(fp);
     printf("primes.txt created\n");
-    free(primesArray);
     
     // End timer and print duration
     end = clock();
@@ -69,41 +178,75 @@ int main(){
 }
 
 void *ThreadFunc(void *pArg){
-    //Split the work across each thread
+    //Take the next CHUNK_SIZE numbers until [0, n) runs out; larger numbers
+    //cost more to test, so equal static blocks would leave the low threads idle
     int rank =*((int*)pArg);
-    int npt= n/NUM_THREADS; //npt = numbers per thread
-    int nptr = n % NUM_THREADS; //nrpt = num per thread remainder
-
-    int sp = rank * npt; // Start point
-	int ep = sp + npt; // End point = start point + npt
-
-	//Add remainders to the first thread
-	if(rank == NUM_THREADS-1)
-		ep += nptr;
-    // Shared memory parallelism
-    for(int i = sp; i< ep; i++){ 
-		if(isPrime(i)){
-            primesArray[i]=i;
+    struct timespec t0, t1;
+
+    while (1){
+        long long sp = atomic_fetch_add(&nextChunk, CHUNK_SIZE); // Start point
+        if (sp >= n)
+            break;
+        long long ep = sp + CHUNK_SIZE < n ? sp + CHUNK_SIZE : n; // End point
+
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t0);
+        for(long long i = sp; i< ep; i++){
+            if(isPrime64(i)){
+                primeSetAdd(&primes, i);
+            }
         }
-	}
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t1);
+        busyTime[rank] += elapsedSeconds(t0, t1);
+        workDone[rank]++;
+    }
+    return NULL;
 }
 
-// Reference: https://www.geeksforgeeks.org/print-all-prime-numbers-less-than-or-equal-to-n/
-bool isPrime(int n){
-    // Edge cases
-    if (n <= 1)
-        return false;
-    if (n <= 3)
-        return true;
-
-    // An optimisation to reduce the number of iterations in the 'for' loop
-    if(n % 2 == 0 || n % 3 == 0)
-        return false;
-
-    for(int i = 5; i <= sqrt(n); i = i + 6){
-        if (n % i == 0 || n % (i + 2) == 0)
-            return false;
+void *SieveThreadFunc(void *pArg){
+    int rank =*((int*)pArg);
+    uint64_t numSegments = sieveNumSegments(&sieve);
+    uint8_t *flags = (uint8_t*)malloc(SIEVE_SEGMENT_BYTES);
+    uint64_t *found = (uint64_t*)malloc(SIEVE_SEGMENT_BYTES * sizeof(uint64_t));
+    off_t roundStart = sieveStart;
+    struct timespec t0, t1;
+
+    //Segments all cost about the same, so a fixed round-robin keeps the threads balanced
+    //and lets each round be written in order
+    for (uint64_t round = 0; round * numThreads < numSegments; round++){
+        //Thread i sieves and formats segment round * numThreads + i
+        int b = round % 2;
+        uint64_t k = round * numThreads + rank;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t0);
+        sieveTextLen[b][rank] = 0;
+        if (k < numSegments){
+            size_t count = sieveSegment(&sieve, k, flags, found);
+            sieveTextLen[b][rank] = formatPrimes(sieveText[b][rank], found, count);
+            workDone[rank]++;
+        }
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t1);
+        busyTime[rank] += elapsedSeconds(t0, t1);
+        pthread_barrier_wait(&roundBarrier);
+
+        //Every thread finds its offset from the lengths before it and writes concurrently.
+        //This round's buffers are not reused until the round after next, which no thread
+        //can start before everyone has passed the next barrier.
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t0);
+        off_t offset = roundStart;
+        for (int i = 0; i < rank; i++)
+            offset += sieveTextLen[b][i];
+        writerPwrite(sieveFd, sieveText[b][rank], sieveTextLen[b][rank], offset);
+        for (int i = 0; i < numThreads; i++)
+            roundStart += sieveTextLen[b][i];
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t1);
+        busyTime[rank] += elapsedSeconds(t0, t1);
     }
+    if (rank == 0)
+        sieveEnd = roundStart;
+    free(flags);
+    free(found);
+    return NULL;
+}
 
-    return true;
+double elapsedSeconds(struct timespec start, struct timespec end){
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
 }
@@ -0,0 +1,113 @@
+/*
+ * Deterministic Miller-Rabin with Montgomery multiplication, after a small-prime filter.
+ *
+ * Numbers are kept in Montgomery form a * 2^64 mod n. A product then needs
+ * one 128-bit multiply and a reduction made of multiplies, with no division.
+ */
+#include "primes_primality.h"
+#include <stddef.h>
+
+typedef unsigned __int128 uint128_t;
+
+//Odd modulus n with n * nInv = 1 mod 2^64, plus 1 and -1 in Montgomery form
+typedef struct {
+    uint64_t n, nInv;
+    uint64_t one, minusOne;
+} montgomery;
+
+static const uint32_t smallPrimes[] = {3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53};
+#define NUM_SMALL_PRIMES (sizeof(smallPrimes) / sizeof(smallPrimes[0]))
+//Bit k is set when k is prime, for k < 64
+#define PRIMES_BELOW_64 0x28208a20a08a28acULL
+
+static const uint64_t bases32[] = {2, 7, 61};
+static const uint64_t bases64[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+
+//Function Declarations
+static void montInit(montgomery *m, uint64_t n);
+static inline uint64_t montReduce(const montgomery *m, uint128_t t);
+static inline uint64_t montMul(const montgomery *m, uint64_t a, uint64_t b);
+static bool isStrongProbablePrime(const montgomery *m, uint64_t a, uint64_t d, int s);
+
+static void montInit(montgomery *m, uint64_t n)
+{
+    //Newton's iteration doubles the correct low bits each step; n itself is right to 3
+    uint64_t inv = n;
+    for (int i = 0; i < 5; i++)
+        inv *= 2 - n * inv;
+    m->n = n;
+    m->nInv = inv;
+    m->one = (0 - n) % n;
+    m->minusOne = n - m->one;
+}
+
+//t * 2^-64 mod n for t < n * 2^64. Subtracting the high half of q * n rather than
+//adding it cannot overflow, even when n is close to 2^64.
+static inline uint64_t montReduce(const montgomery *m, uint128_t t)
+{
+    uint64_t q = (uint64_t)t * m->nInv;
+    uint64_t hi = (uint64_t)(t >> 64);
+    uint64_t qnHi = (uint64_t)(((uint128_t)q * m->n) >> 64);
+    return hi >= qnHi ? hi - qnHi : hi - qnHi + m->n;
+}
+
+static inline uint64_t montMul(const montgomery *m, uint64_t a, uint64_t b)
+{
+    return montReduce(m, (uint128_t)a * b);
+}
+
+//Miller-Rabin round for base a, where n - 1 = d * 2^s with d odd
+static bool isStrongProbablePrime(const montgomery *m, uint64_t a, uint64_t d, int s)
+{
+    a %= m->n;
+    if (a == 0)
+        return true;
+
+    //x = a^d in Montgomery form
+    uint64_t base = (uint64_t)(((uint128_t)a << 64) % m->n);
+    uint64_t x = m->one;
+    for (; d > 0; d >>= 1) {
+        if (d & 1)
+            x = montMul(m, x, base);
+        base = montMul(m, base, base);
+    }
+    if (x == m->one || x == m->minusOne)
+        return true;
+    for (int i = 1; i < s; i++) {
+        x = montMul(m, x, x);
+        if (x == m->minusOne)
+            return true;
+    }
+    return false;
+}
+
+bool isPrime64(uint64_t n)
+{
+    if (n < 64)
+        return (PRIMES_BELOW_64 >> n) & 1;
+    if (n % 2 == 0)
+        return false;
+    for (size_t i = 0; i < NUM_SMALL_PRIMES; i++) {
+        if (n % smallPrimes[i] == 0)
+            return false;
+    }
+    //No factor up to 53, so anything below 59 * 59 is prime
+    if (n < 59 * 59)
+        return true;
+
+    uint64_t d = n - 1;
+    int s = 0;
+    while ((d & 1) == 0) {
+        d >>= 1;
+        s++;
+    }
+    montgomery m;
+    montInit(&m, n);
+    const uint64_t *bases = n < (1ULL << 32) ? bases32 : bases64;
+    size_t numBases = n < (1ULL << 32) ? sizeof(bases32) / sizeof(bases32[0]) : sizeof(bases64) / sizeof(bases64[0]);
+    for (size_t i = 0; i < numBases; i++) {
+        if (!isStrongProbablePrime(&m, bases[i], d, s))
+            return false;
+    }
+    return true;
+}
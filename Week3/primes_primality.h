@@ -0,0 +1,18 @@
+/*
+ * Primality test for any 64-bit number.
+ *
+ * Numbers with a prime factor up to 53 are settled by a few divisions, which
+ * covers most composites. What is left goes through Miller-Rabin with Montgomery
+ * multiplication. Fixed bases make it deterministic: {2, 7, 61} are enough below
+ * 2^32 and Jim Sinclair's seven bases are enough for every 64-bit number.
+ */
+#ifndef PRIMES_PRIMALITY_H
+#define PRIMES_PRIMALITY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//Whether n is prime. Safe to call from any number of threads.
+bool isPrime64(uint64_t n);
+
+#endif
@@ -3,10 +3,28 @@
 #include<math.h>
 #include<time.h>
 #include <stdbool.h>
+#include<string.h>
+#include "primes_sieve.h"
+#include "primes_bitset.h"
+#include "primes_writer.h"
+#include "primes_count.h"
+#include "primes_primality.h"
 
-bool isPrime(int n);
+void writeSievePrimes(FILE *fp, long long n);
+
+// usage: primes_serial_with_timer [-m sieve|trial|count]
+// build: gcc primes_serial_with_timer.c primes_sieve.c primes_bitset.c primes_primality.c primes_writer.c primes_count.c -lm -lpthread
+int main(int argc, char *argv[]){
+    // Pick the method: segmented sieve (default), testing each number, or only count the primes
+    bool useSieve = true, useCount = false;
+    if (argc == 3 && strcmp(argv[1], "-m") == 0 && (strcmp(argv[2], "sieve") == 0 || strcmp(argv[2], "trial") == 0 || strcmp(argv[2], "count") == 0)){
+        useSieve = strcmp(argv[2], "sieve") == 0;
+        useCount = strcmp(argv[2], "count") == 0;
+    } else if (argc != 1){
+        printf("usage: %s [-m sieve|trial|count]\n", argv[0]);
+        return 1;
+    }
 
-int main(){
     // Initialise variables for timing program runtime
     clock_t start, end;
     double cpu_time_used;
@@ -16,27 +34,47 @@ int main(){
     printf("Enter a number: ");
 
     // Read user input and store it in variable 'n'
-    int n;
-    scanf("%d", &n);
-    
-    int *primesArray = (int*)malloc(n * sizeof(int));
+    long long n;
+    scanf("%lld", &n);
      
+    if (useCount){
+        //Count without listing: no file is written
+        if (n > (long long)PRIME_COUNT_MAX_LIMIT){
+            printf("n is too large to count\n");
+            return 1;
+        }
+        printf("%llu primes less than %lld\n", (unsigned long long)primeCount(n > 0 ? n : 0), n);
+
+        // End timer and print duration
+        end = clock();
+        cpu_time_used = ((double) (end - start)) / CLOCKS_PER_SEC;
+        printf("This program took %f to execute\n", cpu_time_used);
+        return 0;
+    }
+
     // Create a file named "primes.txt"
     FILE *fp;
     fp = fopen("primes.txt", "w+");
-    fprintf(fp, "Prime Number less than %d:\n",n);
+    fprintf(fp, "Prime Number less than %lld:\n",n);
 
-    //Find primes and store in array
-    for(int i = 2; i <= n; i++){
-        if(isPrime(i)){
-            primesArray[i]=i;
+    if (useSieve){
+        writeSievePrimes(fp, n);
+    } else {
+        //Find primes and store them in a bit-packed set
+        primeSet primes;
+        if (primeSetInit(&primes, 0, n > 0 ? n : 0) != 0){
+            printf("Not enough memory for n = %lld\n", n);
+            return 1;
         }
-    }
-    
-    //Write prime numbers to file
-    for (int i=0; i<n; i++){
-        if (primesArray[i])
-            fprintf(fp, "%d\n", i);
+        for(long long i = 2; i < n; i++){
+            if(isPrime64(i)){
+                primeSetAdd(&primes, i);
+            }
+        }
+
+        //Write prime numbers to file
+        primeSetWriteParallel(fp, &primes, 1);
+        primeSetFree(&primes);
     }
 
     fclose(fp);
@@ -50,22 +88,24 @@ int main(){
     return 0;
 }
 
-// Reference: https://www.geeksforgeeks.org/print-all-prime-numbers-less-than-or-equal-to-n/
-bool isPrime(int n){
-    // Edge cases
-    if (n <= 1)
-        return false;
-    if (n <= 3)
-        return true;
-
-    // An optimisation to reduce the number of iterations in the 'for' loop
-    if(n % 2 == 0 || n % 3 == 0)
-        return false;
+//Sieve [0, n) one cache-sized segment at a time and write each segment's primes
+void writeSievePrimes(FILE *fp, long long n){
+    primeSieve sieve;
+    if (sieveInit(&sieve, n > 0 ? n : 0) != 0){
+        printf("n is too large for the sieve\n");
+        exit(1);
+    }
+    uint8_t *flags = (uint8_t*)malloc(SIEVE_SEGMENT_BYTES);
+    uint64_t *found = (uint64_t*)malloc(SIEVE_SEGMENT_BYTES * sizeof(uint64_t));
+    char *text = (char*)malloc(SIEVE_SEGMENT_BYTES * WRITER_MAX_LINE);
 
-    for(int i = 5; i <= sqrt(n); i = i + 6){
-        if (n % i == 0 || n % (i + 2) == 0)
-            return false;
+    for (uint64_t k = 0; k < sieveNumSegments(&sieve); k++){
+        size_t count = sieveSegment(&sieve, k, flags, found);
+        fwrite(text, 1, formatPrimes(text, found, count), fp);
     }
 
-    return true;
+    free(flags);
+    free(found);
+    free(text);
+    sieveFree(&sieve);
 }
@@ -0,0 +1,144 @@
+/*
+ * Segmented Sieve of Eratosthenes with odd-only storage and a 2*3*5 wheel.
+ *
+ * Flag j of segment [lo, hi) stands for the odd number lo + 2j + 1. Odd numbers
+ * repeat their divisibility by 3 and 5 every 15 flags, so a segment starts as a
+ * copy of that pattern at the right phase rather than being sieved by 3 and 5.
+ */
+#include "primes_sieve.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+//Period of the 2*3*5 wheel in odd numbers (30 integers)
+#define WHEEL_ODDS 15
+
+//Function Declarations
+static uint64_t isqrt(uint64_t n);
+static int buildWheelTile(primeSieve *s);
+
+static uint64_t isqrt(uint64_t n)
+{
+    uint64_t r = (uint64_t)sqrt((double)n);
+    while (r * r > n)
+        r--;
+    while ((r + 1) * (r + 1) <= n)
+        r++;
+    return r;
+}
+
+int sieveInit(primeSieve *s, uint64_t limit)
+{
+    memset(s, 0, sizeof(primeSieve));
+    if (limit > SIEVE_MAX_LIMIT)
+        return -1;
+    s->limit = limit;
+
+    //Plain sieve for the sieving primes up to sqrt(limit); 2, 3 and 5 are left to the wheel
+    uint64_t root = isqrt(limit);
+    uint8_t *composite = (uint8_t*)calloc(root + 1, 1);
+    s->primes = (uint32_t*)malloc((root / 2 + 1) * sizeof(uint32_t));
+    if (composite == NULL || s->primes == NULL || buildWheelTile(s) != 0) {
+        free(composite);
+        sieveFree(s);
+        return -1;
+    }
+    for (uint64_t i = 2; i <= root; i++) {
+        if (composite[i])
+            continue;
+        if (i >= 7)
+            s->primes[s->numPrimes++] = (uint32_t)i;
+        for (uint64_t j = i * i; j <= root; j += i)
+            composite[j] = 1;
+    }
+    free(composite);
+    return 0;
+}
+
+int sieveInitWithPrimes(primeSieve *s, uint64_t limit, const uint32_t *primes, size_t numPrimes)
+{
+    memset(s, 0, sizeof(primeSieve));
+    if (limit > SIEVE_MAX_LIMIT)
+        return -1;
+    s->limit = limit;
+    s->primes = (uint32_t*)malloc((numPrimes > 0 ? numPrimes : 1) * sizeof(uint32_t));
+    if (s->primes == NULL || buildWheelTile(s) != 0) {
+        sieveFree(s);
+        return -1;
+    }
+    memcpy(s->primes, primes, numPrimes * sizeof(uint32_t));
+    s->numPrimes = numPrimes;
+    return 0;
+}
+
+//Flag i of the tile is the odd number 2i + 1
+static int buildWheelTile(primeSieve *s)
+{
+    s->wheelTile = (uint8_t*)malloc(SIEVE_SEGMENT_BYTES + WHEEL_ODDS);
+    if (s->wheelTile == NULL)
+        return -1;
+    for (size_t i = 0; i < SIEVE_SEGMENT_BYTES + WHEEL_ODDS; i++) {
+        uint64_t v = 2 * i + 1;
+        s->wheelTile[i] = (v % 3 != 0 && v % 5 != 0);
+    }
+    return 0;
+}
+
+void sieveFree(primeSieve *s)
+{
+    free(s->primes);
+    free(s->wheelTile);
+    s->primes = NULL;
+    s->wheelTile = NULL;
+    s->numPrimes = 0;
+}
+
+uint64_t sieveNumSegments(const primeSieve *s)
+{
+    return (s->limit + SIEVE_SEGMENT_SPAN - 1) / SIEVE_SEGMENT_SPAN;
+}
+
+size_t sieveSegment(const primeSieve *s, uint64_t k, uint8_t *flags, uint64_t *primes)
+{
+    uint64_t lo = k * SIEVE_SEGMENT_SPAN;
+    if (lo >= s->limit)
+        return 0;
+    uint64_t hi = s->limit - lo < SIEVE_SEGMENT_SPAN ? s->limit : lo + SIEVE_SEGMENT_SPAN;
+    return sieveRange(s, lo, hi, flags, primes);
+}
+
+size_t sieveRange(const primeSieve *s, uint64_t lo, uint64_t hi, uint8_t *flags, uint64_t *primes)
+{
+    size_t numOdds = (size_t)((hi - lo) / 2);
+
+    //Stamp the wheel at the phase of lo + 1, which is tile flag lo / 2
+    memcpy(flags, s->wheelTile + (lo / 2) % WHEEL_ODDS, numOdds);
+
+    //Cross off odd multiples of each sieving prime, starting no lower than p * p
+    for (size_t i = 0; i < s->numPrimes; i++) {
+        uint64_t p = s->primes[i];
+        uint64_t start = p * p;
+        if (start >= hi)
+            break;
+        if (start < lo) {
+            start = (lo + p - 1) / p * p;
+            if ((start & 1) == 0)
+                start += p;
+        }
+        for (uint64_t j = (start - lo) / 2; j < numOdds; j += p)
+            flags[j] = 0;
+    }
+
+    //The wheel removed 3 and 5 themselves and 1 is not prime
+    size_t count = 0;
+    static const uint64_t wheelPrimes[] = { 2, 3, 5 };
+    for (int i = 0; i < 3; i++)
+        if (wheelPrimes[i] >= lo && wheelPrimes[i] < hi)
+            primes[count++] = wheelPrimes[i];
+    if (lo == 0 && numOdds > 0)
+        flags[0] = 0;
+    for (size_t j = 0; j < numOdds; j++)
+        if (flags[j])
+            primes[count++] = lo + 2 * j + 1;
+    return count;
+}
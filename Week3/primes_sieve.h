@@ -0,0 +1,45 @@
+/*
+ * Segmented Sieve of Eratosthenes.
+ *
+ * [0, limit) is cut into fixed segments of SIEVE_SEGMENT_SPAN numbers. Each segment
+ * only stores odd numbers (one byte each) and is sized to stay in cache. It is
+ * pre-stamped with the 2*3*5 wheel pattern, so only primes from 7 up to
+ * sqrt(limit) are crossed off. Segments are independent, which means any thread
+ * can sieve any segment once sieveInit has run.
+ */
+#ifndef PRIMES_SIEVE_H
+#define PRIMES_SIEVE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+//One byte per odd number: 128 KiB of flags covers 256 Ki numbers
+#define SIEVE_SEGMENT_BYTES (128 * 1024)
+#define SIEVE_SEGMENT_SPAN (2 * (uint64_t)SIEVE_SEGMENT_BYTES)
+//Largest supported limit (sieving primes must fit in 32 bits)
+#define SIEVE_MAX_LIMIT 10000000000000ULL
+
+typedef struct {
+    uint64_t limit;         //Primes below limit are reported
+    uint32_t *primes;       //Sieving primes 7 <= p <= sqrt(limit)
+    size_t numPrimes;
+    uint8_t *wheelTile;     //2*3*5 pattern, long enough to copy a whole segment from any phase
+} primeSieve;
+
+//Prepare to sieve [0, limit). Returns 0 on success, -1 if limit is too large or memory runs out
+int sieveInit(primeSieve *s, uint64_t limit);
+//Same, but with sieving primes computed elsewhere (e.g. received from another process).
+//primes must hold every prime from 7 up to sqrt(limit) in increasing order; it is copied
+int sieveInitWithPrimes(primeSieve *s, uint64_t limit, const uint32_t *primes, size_t numPrimes);
+void sieveFree(primeSieve *s);
+uint64_t sieveNumSegments(const primeSieve *s);
+
+//Sieve segment k, i.e. [k * SIEVE_SEGMENT_SPAN, (k + 1) * SIEVE_SEGMENT_SPAN) cut at the limit.
+//flags is scratch space of SIEVE_SEGMENT_BYTES bytes. The segment's primes are stored
+//in increasing order in primes, which needs room for SIEVE_SEGMENT_BYTES values.
+//Returns how many there are.
+size_t sieveSegment(const primeSieve *s, uint64_t k, uint8_t *flags, uint64_t *primes);
+//Same for any [lo, hi) with lo even, hi <= limit and hi - lo <= SIEVE_SEGMENT_SPAN
+size_t sieveRange(const primeSieve *s, uint64_t lo, uint64_t hi, uint8_t *flags, uint64_t *primes);
+
+#endif
@@ -0,0 +1,182 @@
+/*
+ * Fast prime list output: two-digit itoa, prefix-summed offsets, concurrent pwrite.
+ */
+#include "primes_writer.h"
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+
+//Each thread formats into a buffer of this size and writes it out when nearly full
+#define WRITER_BUFFER_BYTES (1 << 20)
+#define MAX_WRITER_THREADS 256
+
+typedef struct {
+    const primeSet *s;
+    uint64_t firstWord, endWord;    //This thread's words of the set
+    int fd;
+    off_t offset;                   //Where this thread's text starts in the file
+    uint64_t bytes;                 //Length of this thread's text
+    int failed;
+} writerTask;
+
+static const char digitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+//Function Declarations
+static char *appendNumber(char *p, uint64_t value);
+static void *countFunc(void *pArg);
+static void *writeFunc(void *pArg);
+static void runTasks(void *(*func)(void *), writerTask *tasks, int numTasks);
+
+size_t formattedLength(uint64_t value)
+{
+    //Stop before 10^20, which does not fit in 64 bits
+    size_t digits = 1;
+    for (uint64_t limit = 10; value >= limit && digits < 20; limit *= 10)
+        digits++;
+    return digits + 1;
+}
+
+//Write value and a newline at p and return the end
+static char *appendNumber(char *p, uint64_t value)
+{
+    char *end = p + formattedLength(value) - 1;
+    char *q = end;
+    while (value >= 100) {
+        unsigned pair = (unsigned)(value % 100) * 2;
+        value /= 100;
+        q -= 2;
+        q[0] = digitPairs[pair];
+        q[1] = digitPairs[pair + 1];
+    }
+    if (value >= 10) {
+        q -= 2;
+        q[0] = digitPairs[value * 2];
+        q[1] = digitPairs[value * 2 + 1];
+    }
+    else {
+        *--q = (char)('0' + value);
+    }
+    *end = '\n';
+    return end + 1;
+}
+
+size_t formatPrimes(char *out, const uint64_t *values, size_t count)
+{
+    char *p = out;
+    for (size_t i = 0; i < count; i++)
+        p = appendNumber(p, values[i]);
+    return (size_t)(p - out);
+}
+
+uint64_t primeSetTextLength(const primeSet *s, uint64_t firstWord, uint64_t endWord)
+{
+    uint64_t bytes = 0;
+    for (uint64_t w = firstWord; w < endWord; w++) {
+        for (uint64_t bits = s->words[w]; bits != 0; bits &= bits - 1)
+            bytes += formattedLength(primeSetBitValue(s, w * 64 + __builtin_ctzll(bits)));
+    }
+    return bytes;
+}
+
+size_t primeSetFormatWords(char *out, size_t cap, const primeSet *s, uint64_t *word, uint64_t endWord)
+{
+    char *p = out;
+    uint64_t w = *word;
+    //A word holds at most 64 members, so stop once another word might not fit
+    for (; w < endWord && (size_t)(p - out) + 64 * WRITER_MAX_LINE <= cap; w++) {
+        for (uint64_t bits = s->words[w]; bits != 0; bits &= bits - 1)
+            p = appendNumber(p, primeSetBitValue(s, w * 64 + __builtin_ctzll(bits)));
+    }
+    *word = w;
+    return (size_t)(p - out);
+}
+
+int writerPwrite(int fd, const char *buf, size_t len, off_t offset)
+{
+    while (len > 0) {
+        ssize_t done = pwrite(fd, buf, len, offset);
+        if (done <= 0)
+            return -1;
+        buf += done;
+        len -= (size_t)done;
+        offset += done;
+    }
+    return 0;
+}
+
+//Pass 1: how many bytes this thread's members take
+static void *countFunc(void *pArg)
+{
+    writerTask *task = (writerTask*)pArg;
+    task->bytes = primeSetTextLength(task->s, task->firstWord, task->endWord);
+    return NULL;
+}
+
+//Pass 2: format and write this thread's members from its offset on
+static void *writeFunc(void *pArg)
+{
+    writerTask *task = (writerTask*)pArg;
+    char *buf = (char*)malloc(WRITER_BUFFER_BYTES);
+    off_t offset = task->offset;
+    uint64_t w = task->firstWord;
+    while (w < task->endWord && !task->failed) {
+        size_t len = primeSetFormatWords(buf, WRITER_BUFFER_BYTES, task->s, &w, task->endWord);
+        task->failed = writerPwrite(task->fd, buf, len, offset) != 0;
+        offset += len;
+    }
+    free(buf);
+    return NULL;
+}
+
+//Fork one thread per task and join them
+static void runTasks(void *(*func)(void *), writerTask *tasks, int numTasks)
+{
+    pthread_t tid[MAX_WRITER_THREADS];
+    for (int i = 1; i < numTasks; i++)
+        pthread_create(&tid[i], NULL, func, &tasks[i]);
+    func(&tasks[0]);
+    for (int i = 1; i < numTasks; i++)
+        pthread_join(tid[i], NULL);
+}
+
+int primeSetWriteParallel(FILE *fp, const primeSet *s, int numThreads)
+{
+    if (numThreads > MAX_WRITER_THREADS)
+        numThreads = MAX_WRITER_THREADS;
+    if ((uint64_t)numThreads > s->numWords)
+        numThreads = (int)s->numWords;
+    if (numThreads < 1)
+        numThreads = 1;
+
+    //The text goes after whatever fp has already written
+    fflush(fp);
+    int fd = fileno(fp);
+    off_t start = ftello(fp);
+
+    writerTask tasks[MAX_WRITER_THREADS];
+    for (int i = 0; i < numThreads; i++) {
+        tasks[i].s = s;
+        tasks[i].firstWord = s->numWords * i / numThreads;
+        tasks[i].endWord = s->numWords * (i + 1) / numThreads;
+        tasks[i].fd = fd;
+        tasks[i].failed = 0;
+    }
+    runTasks(countFunc, tasks, numThreads);
+
+    //Prefix sum of the chunk lengths gives each chunk's offset
+    off_t offset = start;
+    for (int i = 0; i < numThreads; i++) {
+        tasks[i].offset = offset;
+        offset += tasks[i].bytes;
+    }
+    runTasks(writeFunc, tasks, numThreads);
+
+    int failed = 0;
+    for (int i = 0; i < numThreads; i++)
+        failed |= tasks[i].failed;
+    fseeko(fp, offset, SEEK_SET);
+    return failed ? -1 : 0;
+}
@@ -0,0 +1,42 @@
+/*
+ * Fast output of prime lists, one decimal number per line.
+ *
+ * Numbers are formatted with a two-digits-at-a-time itoa into large buffers
+ * instead of one fprintf call each. The parallel writer first counts the bytes
+ * each thread will produce and takes a prefix sum to find every chunk's file
+ * offset. The threads then pwrite their chunks into the same file concurrently.
+ */
+#ifndef PRIMES_WRITER_H
+#define PRIMES_WRITER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include "primes_bitset.h"
+
+//Most bytes one formatted number can take, newline included
+#define WRITER_MAX_LINE 21
+
+//Bytes that formatting value takes, newline included
+size_t formattedLength(uint64_t value);
+//Format count values as lines into out, which needs count * WRITER_MAX_LINE bytes
+//in the worst case. Returns the number of bytes written.
+size_t formatPrimes(char *out, const uint64_t *values, size_t count);
+
+//Bytes that formatting the members in words [firstWord, endWord) of s takes
+uint64_t primeSetTextLength(const primeSet *s, uint64_t firstWord, uint64_t endWord);
+//Format the members of s from word *word on into out, one whole word at a time, until
+//endWord or until out's cap bytes could overflow. cap must be at least
+//64 * WRITER_MAX_LINE. Advances *word past what was formatted and returns the bytes written.
+size_t primeSetFormatWords(char *out, size_t cap, const primeSet *s, uint64_t *word, uint64_t endWord);
+
+//pwrite all of buf at offset, retrying short writes. Returns 0 on success, -1 on error
+int writerPwrite(int fd, const char *buf, size_t len, off_t offset);
+
+//Write every member of s at fp's current position, the same text primeSetWrite
+//produces, using up to numThreads threads. Leaves fp positioned after the text.
+//Returns 0 on success, -1 on a write error.
+int primeSetWriteParallel(FILE *fp, const primeSet *s, int numThreads);
+
+#endif
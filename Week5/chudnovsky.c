@@ -0,0 +1,255 @@
+/*
+ * Chudnovsky binary splitting with GMP: serial recursion, thread-parallel pieces
+ * and merges, and a binary-tree merge across MPI processes.
+ */
+#include "chudnovsky.h"
+#include <stdlib.h>
+#include <pthread.h>
+
+#define MAX_CHUD_THREADS 256
+#define TAG_CHUD 3
+//C^3 / 24 for C = 640320
+#define C3_OVER_24 10939058860032000UL
+//Extra digits carried through the square root and division, then dropped
+#define GUARD_DIGITS 8
+
+//One product of a merge, or one piece of a split, for a helper thread
+typedef struct {
+    mpz_ptr out;
+    mpz_srcptr x, y;
+} mulTask;
+
+typedef struct {
+    chudTerm *left, *right, *term;
+    long a, b;
+    int needP, numThreads;
+} splitTask;
+
+//Function Declarations
+static void *mulThreadFunc(void *pArg);
+static void *splitThreadFunc(void *pArg);
+static void *mergeThreadFunc(void *pArg);
+static void sendTerm(const chudTerm *t, int dest, MPI_Comm comm);
+static void recvTerm(chudTerm *t, int source, MPI_Comm comm);
+
+void chudInit(chudTerm *t)
+{
+    mpz_inits(t->P, t->Q, t->T, NULL);
+}
+
+void chudClear(chudTerm *t)
+{
+    mpz_clears(t->P, t->Q, t->T, NULL);
+}
+
+long chudNumTerms(long digits)
+{
+    return (long)(digits / CHUD_DIGITS_PER_TERM) + 2;
+}
+
+void chudSplit(chudTerm *r, long a, long b, int needP)
+{
+    if (b - a == 1) {
+        //P = -(6a - 5)(2a - 1)(6a - 1),  Q = a^3 C^3 / 24,  T = P (13591409 + 545140134 a)
+        mpz_set_ui(r->P, 6 * a - 5);
+        mpz_mul_ui(r->P, r->P, 2 * a - 1);
+        mpz_mul_ui(r->P, r->P, 6 * a - 1);
+        mpz_neg(r->P, r->P);
+        mpz_set_ui(r->Q, a);
+        mpz_mul_ui(r->Q, r->Q, a);
+        mpz_mul_ui(r->Q, r->Q, a);
+        mpz_mul_ui(r->Q, r->Q, C3_OVER_24);
+        mpz_mul_ui(r->T, r->P, 13591409UL + 545140134UL * a);
+        if (!needP)
+            mpz_set_ui(r->P, 0);
+        return;
+    }
+    long m = (a + b) / 2;
+    chudTerm right;
+    chudInit(&right);
+    chudSplit(r, a, m, 1);
+    chudSplit(&right, m, b, needP);
+    chudMerge(r, &right, needP, 1);
+    chudClear(&right);
+}
+
+static void *mulThreadFunc(void *pArg)
+{
+    mulTask *task = (mulTask*)pArg;
+    mpz_mul(task->out, task->x, task->y);
+    return NULL;
+}
+
+void chudMerge(chudTerm *left, chudTerm *right, int needP, int numThreads)
+{
+    //T1 * Q2, P1 * T2, Q1 * Q2 and P1 * P2 only read the inputs, so they can run at once
+    mpz_t t1, t2, q, p;
+    mpz_inits(t1, t2, q, p, NULL);
+    mulTask tasks[4] = {
+        {t1, left->T, right->Q}, {t2, left->P, right->T}, {q, left->Q, right->Q}, {p, left->P, right->P}
+    };
+    int numTasks = needP ? 4 : 3;
+    int numHelpers = numThreads - 1 < numTasks - 1 ? numThreads - 1 : numTasks - 1;
+    pthread_t tid[3];
+    for (int i = 0; i < numHelpers; i++)
+        pthread_create(&tid[i], NULL, mulThreadFunc, &tasks[i + 1]);
+    mulThreadFunc(&tasks[0]);
+    for (int i = numHelpers + 1; i < numTasks; i++)
+        mulThreadFunc(&tasks[i]);
+    for (int i = 0; i < numHelpers; i++)
+        pthread_join(tid[i], NULL);
+
+    mpz_add(left->T, t1, t2);
+    mpz_swap(left->Q, q);
+    if (needP)
+        mpz_swap(left->P, p);
+    else
+        mpz_set_ui(left->P, 0);
+    mpz_clears(t1, t2, q, p, NULL);
+}
+
+static void *splitThreadFunc(void *pArg)
+{
+    splitTask *task = (splitTask*)pArg;
+    chudSplit(task->term, task->a, task->b, task->needP);
+    return NULL;
+}
+
+static void *mergeThreadFunc(void *pArg)
+{
+    splitTask *task = (splitTask*)pArg;
+    chudMerge(task->left, task->right, task->needP, task->numThreads);
+    return NULL;
+}
+
+void chudSplitParallel(chudTerm *r, long a, long b, int needP, int numThreads)
+{
+    if (numThreads > MAX_CHUD_THREADS)
+        numThreads = MAX_CHUD_THREADS;
+    if (numThreads > b - a)
+        numThreads = (int)(b - a);
+    if (numThreads <= 1) {
+        chudSplit(r, a, b, needP);
+        return;
+    }
+
+    //Every thread takes an equal run of terms; the last piece may skip P
+    chudTerm pieces[MAX_CHUD_THREADS];
+    splitTask tasks[MAX_CHUD_THREADS];
+    pthread_t tid[MAX_CHUD_THREADS];
+    for (int i = 0; i < numThreads; i++) {
+        chudInit(&pieces[i]);
+        tasks[i].term = &pieces[i];
+        tasks[i].a = a + (b - a) * i / numThreads;
+        tasks[i].b = a + (b - a) * (i + 1) / numThreads;
+        tasks[i].needP = needP || i < numThreads - 1;
+    }
+    for (int i = 1; i < numThreads; i++)
+        pthread_create(&tid[i], NULL, splitThreadFunc, &tasks[i]);
+    splitThreadFunc(&tasks[0]);
+    for (int i = 1; i < numThreads; i++)
+        pthread_join(tid[i], NULL);
+
+    //Merge neighbours up a binary tree. A level's merges run side by side, and the
+    //threads left over help with each merge's products.
+    for (int step = 1; step < numThreads; step *= 2) {
+        int numMerges = 0;
+        for (int i = 0; i + step < numThreads; i += 2 * step) {
+            tasks[numMerges].left = &pieces[i];
+            tasks[numMerges].right = &pieces[i + step];
+            tasks[numMerges].needP = needP || i + 2 * step < numThreads;
+            numMerges++;
+        }
+        for (int k = 0; k < numMerges; k++)
+            tasks[k].numThreads = numThreads / numMerges;
+        for (int k = 1; k < numMerges; k++)
+            pthread_create(&tid[k], NULL, mergeThreadFunc, &tasks[k]);
+        mergeThreadFunc(&tasks[0]);
+        for (int k = 1; k < numMerges; k++)
+            pthread_join(tid[k], NULL);
+    }
+
+    mpz_swap(r->P, pieces[0].P);
+    mpz_swap(r->Q, pieces[0].Q);
+    mpz_swap(r->T, pieces[0].T);
+    for (int i = 0; i < numThreads; i++)
+        chudClear(&pieces[i]);
+}
+
+//Send sign and size of each number, then their bytes
+static void sendTerm(const chudTerm *t, int dest, MPI_Comm comm)
+{
+    mpz_srcptr values[3] = {t->P, t->Q, t->T};
+    long long header[6];
+    void *bytes[3];
+    for (int i = 0; i < 3; i++) {
+        size_t count;
+        bytes[i] = mpz_export(NULL, &count, 1, 1, 0, 0, values[i]);
+        header[2 * i] = mpz_sgn(values[i]);
+        header[2 * i + 1] = (long long)count;
+    }
+    MPI_Send(header, 6, MPI_LONG_LONG, dest, TAG_CHUD, comm);
+    for (int i = 0; i < 3; i++) {
+        MPI_Send(bytes[i], (int)header[2 * i + 1], MPI_BYTE, dest, TAG_CHUD, comm);
+        free(bytes[i]);
+    }
+}
+
+static void recvTerm(chudTerm *t, int source, MPI_Comm comm)
+{
+    mpz_ptr values[3] = {t->P, t->Q, t->T};
+    long long header[6];
+    MPI_Recv(header, 6, MPI_LONG_LONG, source, TAG_CHUD, comm, MPI_STATUS_IGNORE);
+    for (int i = 0; i < 3; i++) {
+        size_t count = (size_t)header[2 * i + 1];
+        unsigned char *bytes = (unsigned char*)malloc(count > 0 ? count : 1);
+        MPI_Recv(bytes, (int)count, MPI_BYTE, source, TAG_CHUD, comm, MPI_STATUS_IGNORE);
+        mpz_import(values[i], count, 1, 1, 0, 0, bytes);
+        if (header[2 * i] < 0)
+            mpz_neg(values[i], values[i]);
+        free(bytes);
+    }
+}
+
+void chudReduce(MPI_Comm comm, chudTerm *local, int numThreads)
+{
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    //At each level, even blocks take in the piece of the block to their right
+    chudTerm right;
+    chudInit(&right);
+    for (int step = 1; step < size; step *= 2) {
+        if (rank % (2 * step) == step) {
+            sendTerm(local, rank - step, comm);
+            break;
+        }
+        if (rank + step < size) {
+            recvTerm(&right, rank + step, comm);
+            chudMerge(local, &right, rank + 2 * step < size, numThreads);
+        }
+    }
+    chudClear(&right);
+}
+
+void chudPi(mpz_t out, const chudTerm *all, long digits)
+{
+    //sqrt(10005) scaled by 10^(digits + GUARD_DIGITS)
+    mpz_t root, den, scale;
+    mpz_inits(root, den, scale, NULL);
+    mpz_ui_pow_ui(scale, 10, 2 * (digits + GUARD_DIGITS));
+    mpz_mul_ui(root, scale, 10005);
+    mpz_sqrt(root, root);
+
+    //426880 * sqrt(10005) * Q / (13591409 * Q + T)
+    mpz_mul(out, root, all->Q);
+    mpz_mul_ui(out, out, 426880);
+    mpz_mul_ui(den, all->Q, 13591409);
+    mpz_add(den, den, all->T);
+    mpz_tdiv_q(out, out, den);
+
+    mpz_ui_pow_ui(scale, 10, GUARD_DIGITS);
+    mpz_tdiv_q(out, out, scale);
+    mpz_clears(root, den, scale, NULL);
+}
@@ -0,0 +1,45 @@
+/*
+ * Digits of pi from the Chudnovsky series by binary splitting, with GMP.
+ *
+ *   pi = 426880 * sqrt(10005) * Q(1, n) / (13591409 * Q(1, n) + T(1, n))
+ *
+ * P, Q and T of a range of terms [a, b) come from those of [a, m) and [m, b):
+ *   P = P1 * P2,  Q = Q1 * Q2,  T = T1 * Q2 + P1 * T2
+ * Ranges are independent, so [1, n) is cut into one piece per process and then
+ * one piece per thread. The pieces are merged back in order: pairs of threads
+ * first, then processes up a binary tree. Each series term adds about 14.18 digits.
+ */
+#ifndef CHUDNOVSKY_H
+#define CHUDNOVSKY_H
+
+#include <gmp.h>
+#include <mpi.h>
+
+#define CHUD_DIGITS_PER_TERM 14.181647462725477
+
+typedef struct {
+    mpz_t P, Q, T;
+} chudTerm;
+
+void chudInit(chudTerm *t);
+void chudClear(chudTerm *t);
+
+//Terms needed for digits decimal places
+long chudNumTerms(long digits);
+
+//P, Q and T of [a, b). P is only needed while more terms follow, so it may be
+//skipped (left 0) for the last range by passing needP = 0.
+void chudSplit(chudTerm *r, long a, long b, int needP);
+//Same, with [a, b) shared among numThreads threads
+void chudSplitParallel(chudTerm *r, long a, long b, int needP, int numThreads);
+//left = left followed by right. The independent products run on up to numThreads threads.
+void chudMerge(chudTerm *left, chudTerm *right, int needP, int numThreads);
+
+//Merge every process's piece into the result on rank 0, where process i holds
+//the i-th range in order. Collective over comm.
+void chudReduce(MPI_Comm comm, chudTerm *local, int numThreads);
+
+//floor(pi * 10^digits) from the terms of [1, n)
+void chudPi(mpz_t out, const chudTerm *all, long digits);
+
+#endif
@@ -0,0 +1,22 @@
+/*
+ * Midpoint rule for pi = integral of 4 / (1 + x^2) over [0, 1] with N strips.
+ *
+ * Term i is 4 / (1 + x^2) at x = (i + 0.5) / N. The kernel evaluates four terms
+ * per vector operation with no pow call and 64-bit indices. Terms are summed in
+ * blocks of PI_BLOCK_TERMS, and the block sums are added with Neumaier's
+ * compensated summation, so the result stays accurate for N up to 10^11 and beyond.
+ */
+#ifndef PI_KERNEL_H
+#define PI_KERNEL_H
+
+//Terms summed directly before a block's total is added with compensation
+#define PI_BLOCK_TERMS 4096
+//Floating point operations per term: index to x (2), x * x, + 1, divide, add
+#define PI_FLOPS_PER_TERM 6
+
+//Sum of terms [first, last) for N strips; divide the sum over all terms by N for pi
+double piKernelSum(long long first, long long last, long long N);
+//Same, with [first, last) split evenly across numThreads threads
+double piKernelSumParallel(long long first, long long last, long long N, int numThreads);
+
+#endif
@@ -0,0 +1,142 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <mpi.h>
+#include "quadrature.h"
+
+//Largest N tried when looking for the fixed midpoint rule that matches the adaptive result
+#define MAX_MIDPOINT_STRIPS (1LL << 28)
+
+double piIntegrand(double x);
+double sqrtIntegrand(double x);
+double logIntegrand(double x);
+double peakIntegrand(double x);
+double waveIntegrand(double x);
+long long midpointStripsFor(const quadProblem *p, double target, double *reached);
+
+// usage: mpirun -np P q5_adaptive [-f pi|sqrt|log|peak|wave] [-e TOLERANCE] [-n MAX_EVALUATIONS]
+// build: mpicc -O2 q5_adaptive.c quadrature.c -lm
+int main(int argc, char* argv[]){
+    struct timespec start, end;
+    double time_taken;
+    int myrank;
+    int numProcessors;
+
+    //Intialise MPI and store rank and numProcessors
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &myrank);
+    MPI_Comm_size(MPI_COMM_WORLD, &numProcessors);
+
+    //Integrands to choose from
+    quadRegister("pi", piIntegrand, 0.0, 1.0, M_PI);
+    quadRegister("sqrt", sqrtIntegrand, 0.0, 1.0, 2.0 / 3.0);
+    quadRegister("log", logIntegrand, 0.0, 1.0, -1.0);
+    quadRegister("peak", peakIntegrand, 0.0, 1.0, 1000.0 * (atan(700.0) + atan(300.0)));
+    quadRegister("wave", waveIntegrand, 0.0, 1.0, sin(100.0) / 100.0);
+
+    //Every process reads the same arguments
+    const quadProblem *problem = quadFind("pi");
+    double tol = 1e-12;
+    long long maxEvaluations = 1000000000LL;
+    int badArgs = argc % 2 == 0;
+    for (int i = 1; i + 1 < argc; i += 2){
+        if (strcmp(argv[i], "-f") == 0)
+            problem = quadFind(argv[i + 1]);
+        else if (strcmp(argv[i], "-e") == 0)
+            tol = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "-n") == 0)
+            maxEvaluations = atoll(argv[i + 1]);
+        else
+            badArgs = 1;
+    }
+    if (badArgs || problem == NULL || !(tol > 0) || maxEvaluations < 1){
+        if (myrank == 0){
+            printf("usage: %s [-f NAME] [-e TOLERANCE] [-n MAX_EVALUATIONS]\nintegrands:", argv[0]);
+            for (int i = 0; i < quadCount(); i++)
+                printf(" %s", quadGet(i)->name);
+            printf("\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Get current clock time.
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    quadResult result;
+    quadIntegrate(MPI_COMM_WORLD, problem, tol, maxEvaluations, &result);
+
+    if (myrank == 0){
+        // Get the clock current time again
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        time_taken = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+
+        //Print output values and time taken
+        printf("Integral of %s over [%g, %g] = %.15f, estimated error %e (tolerance %e)\n",
+               problem->name, problem->a, problem->b, result.value, result.error, tol);
+        printf("Evaluations: %lld, subintervals: %lld, stolen: %lld, reduction rounds: %lld\n",
+               result.evaluations, result.intervals, result.steals, result.rounds);
+        printf("Overall time (p) using %d processors: %lf\n", numProcessors, time_taken);
+
+        //How many strips the uniform midpoint rule of q5 needs to meet the same tolerance
+        if (!isnan(problem->exact)){
+            double actual = fabs(result.value - problem->exact);
+            printf("Actual error: %e\n", actual);
+            double target = fmax(actual, tol);
+            double reached;
+            long long strips = midpointStripsFor(problem, target, &reached);
+            if (strips > 0)
+                printf("Fixed midpoint rule needs N = %lld evaluations for error %e\n", strips, reached);
+            else
+                printf("Fixed midpoint rule still has error %e after N = %lld evaluations\n", reached, MAX_MIDPOINT_STRIPS);
+        }
+    }
+    //Exit
+    MPI_Finalize();
+    return 0;
+}
+
+double piIntegrand(double x){
+    return 4.0 / (1.0 + x * x);
+}
+
+//Infinite slope at 0
+double sqrtIntegrand(double x){
+    return sqrt(x);
+}
+
+//Singular at 0, which Gauss-Kronrod points never touch
+double logIntegrand(double x){
+    return log(x);
+}
+
+//Sharp peak of width 0.001 at 0.3, so nearly all the work lands on one process
+double peakIntegrand(double x){
+    return 1.0 / ((x - 0.3) * (x - 0.3) + 1e-6);
+}
+
+double waveIntegrand(double x){
+    return cos(100.0 * x);
+}
+
+//Smallest power of two N for which the midpoint rule is within target of the exact
+//integral, or -1 if none up to MAX_MIDPOINT_STRIPS is. reached gets the error at N.
+long long midpointStripsFor(const quadProblem *p, double target, double *reached){
+    for (long long N = 1; N <= MAX_MIDPOINT_STRIPS; N *= 2){
+        double h = (p->b - p->a) / (double)N;
+        double sum = 0.0, compensation = 0.0;
+        for (long long i = 0; i < N; i++){
+            //Kahan summation so the comparison is not limited by rounding
+            double y = p->f(p->a + ((double)i + 0.5) * h) - compensation;
+            double t = sum + y;
+            compensation = (t - sum) - y;
+            sum = t;
+        }
+        *reached = fabs(sum * h - p->exact);
+        if (*reached <= target)
+            return N;
+    }
+    return -1;
+}
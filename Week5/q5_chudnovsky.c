@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <mpi.h>
+#include "chudnovsky.h"
+
+//Digits written to the file at a time
+#define WRITE_CHUNK (1 << 20)
+
+//Digit sums and last ten digits after the decimal point, from an independent
+//Machin formula computation
+typedef struct {
+    long digits;
+    long long digitSum;
+    const char *lastTen;
+} knownChecksum;
+
+static const knownChecksum knownChecksums[] = {
+    {30, 147, "2643383279"},
+    {60, 296, "5820974944"},
+    {1000, 4476, "2164201989"},
+    {10000, 44894, "5256375678"},
+    {100000, 449333, "5493624646"},
+    {1000000, 4499934, "5779458151"},
+};
+#define NUM_KNOWN_CHECKSUMS (sizeof(knownChecksums) / sizeof(knownChecksums[0]))
+
+double elapsedSeconds(struct timespec start, struct timespec end);
+
+// usage: mpirun -np P q5_chudnovsky [-t THREADS]   (threads per process default to the online cores)
+// build: mpicc -O2 q5_chudnovsky.c chudnovsky.c -lgmp -lpthread
+int main(int argc, char* argv[]){
+    struct timespec start, split, reduced, computed, end;
+    int myrank;
+    int numProcessors;
+    long digits;
+
+    //Intialise MPI and store rank and numProcessors
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &myrank);
+    MPI_Comm_size(MPI_COMM_WORLD, &numProcessors);
+
+    //Threads per process
+    int numThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (argc == 3 && strcmp(argv[1], "-t") == 0){
+        numThreads = atoi(argv[2]);
+    } else if (argc != 1){
+        numThreads = 0;
+    }
+    if (numThreads < 1){
+        if (myrank == 0)
+            printf("usage: %s [-t THREADS]\n", argv[0]);
+        MPI_Finalize();
+        return 1;
+    }
+
+    //Root process prompts user for the number of digits
+    if (myrank == 0){
+        printf("Enter the number of digits: ");
+        fflush(stdout);
+        scanf("%ld", &digits);
+    }
+    // Get current clock time.
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    MPI_Bcast(&digits, 1, MPI_LONG, 0, MPI_COMM_WORLD);
+    if (digits < 1){
+        if (myrank == 0)
+            printf("The number of digits must be positive\n");
+        MPI_Finalize();
+        return 1;
+    }
+
+    //Each process takes an equal run of the terms [1, n) and shares it among its threads
+    long numTerms = chudNumTerms(digits);
+    long a = 1 + (numTerms - 1) * myrank / numProcessors;
+    long b = 1 + (numTerms - 1) * (myrank + 1) / numProcessors;
+    chudTerm local;
+    chudInit(&local);
+    if (a < b){
+        chudSplitParallel(&local, a, b, myrank < numProcessors - 1, numThreads);
+    } else {
+        //More processes than terms: contribute the identity P = 1, Q = 1, T = 0 so
+        //the merges pass the neighbouring ranges through unchanged
+        mpz_set_ui(local.P, 1);
+        mpz_set_ui(local.Q, 1);
+        mpz_set_ui(local.T, 0);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &split);
+    double splitTime = elapsedSeconds(start, split), slowestSplit;
+    MPI_Reduce(&splitTime, &slowestSplit, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    //Merge the pieces up a tree of processes into rank 0
+    chudReduce(MPI_COMM_WORLD, &local, numThreads);
+    clock_gettime(CLOCK_MONOTONIC, &reduced);
+
+    if (myrank == 0){
+        mpz_t pi;
+        mpz_init(pi);
+        chudPi(pi, &local, digits);
+        clock_gettime(CLOCK_MONOTONIC, &computed);
+
+        //Stream the digits out a chunk at a time, summing them for the checksum
+        char *text = mpz_get_str(NULL, 10, pi);
+        FILE *fp = fopen("pi_digits.txt", "w");
+        fprintf(fp, "3.");
+        long long digitSum = 0;
+        for (long i = 1; i <= digits; i += WRITE_CHUNK){
+            long len = digits - i + 1 < WRITE_CHUNK ? digits - i + 1 : WRITE_CHUNK;
+            for (long j = i; j < i + len; j++)
+                digitSum += text[j] - '0';
+            fwrite(text + i, 1, len, fp);
+        }
+        fprintf(fp, "\n");
+        fclose(fp);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double time_taken = elapsedSeconds(start, end);
+
+        //Print output values and time taken
+        printf("Computed %ld digits of pi (%ld terms) using %d processors x %d threads\n", digits, numTerms, numProcessors, numThreads);
+        printf("Series: %lf (slowest process's own terms), merging processes: %lf, square root and division: %lf, writing: %lf\n",
+               slowestSplit, elapsedSeconds(split, reduced), elapsedSeconds(reduced, computed), elapsedSeconds(computed, end));
+        printf("Overall time (p) using %d processors: %lf\n", numProcessors, time_taken);
+        printf("Digits per second: %.0f\n", digits / time_taken);
+        printf("pi_digits.txt created\n");
+
+        //Compare with a known checksum when there is one for this many digits
+        const char *lastTen = text + 1 + (digits > 10 ? digits - 10 : 0);
+        printf("Checksum: digit sum %lld, last digits %s", digitSum, lastTen);
+        int found = 0;
+        for (size_t k = 0; k < NUM_KNOWN_CHECKSUMS; k++){
+            if (knownChecksums[k].digits == digits){
+                found = 1;
+                int ok = strcmp(lastTen, knownChecksums[k].lastTen) == 0 && knownChecksums[k].digitSum == digitSum;
+                printf(ok ? " - matches the known value\n" : " - DOES NOT match the known value\n");
+            }
+        }
+        if (!found)
+            printf(" - no known checksum for this many digits\n");
+        free(text);
+        mpz_clear(pi);
+    }
+    chudClear(&local);
+    //Exit
+    MPI_Finalize();
+    return 0;
+}
+
+double elapsedSeconds(struct timespec start, struct timespec end){
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+}
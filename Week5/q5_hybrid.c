@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <mpi.h>
+#include "pi_kernel.h"
+
+double elapsedSeconds(struct timespec start, struct timespec end);
+
+// usage: mpirun -np P q5_hybrid [-t THREADS]   (threads per process default to the online cores)
+// build: mpicc -O3 -march=native q5_hybrid.c pi_kernel.c -lm -lpthread
+// Speedup over q5_serial is measured by Benchmark/benchmark.c (-b pi-hybrid)
+int main(int argc, char* argv[]){
+    double localSum = 0.0;
+    double globalSum = 0.0;
+    double piVal;
+    struct timespec start, end;
+    double time_taken;
+    int myrank;
+    int numProcessors;
+    long long N;
+
+    //Intialise MPI and store rank and numProcessors
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &myrank);
+    MPI_Comm_size(MPI_COMM_WORLD, &numProcessors);
+
+    //Threads per process
+    int numThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (argc == 3 && strcmp(argv[1], "-t") == 0){
+        numThreads = atoi(argv[2]);
+    } else if (argc != 1){
+        numThreads = 0;
+    }
+    if (numThreads < 1){
+        if (myrank == 0)
+            printf("usage: %s [-t THREADS]\n", argv[0]);
+        MPI_Finalize();
+        return 1;
+    }
+
+    //Root process prompts user for N
+    if (myrank == 0){
+        printf("Enter a value for N: ");
+        fflush(stdout);
+        scanf("%lld", &N);
+    }
+    // Get current clock time.
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    //Broadcast the value of N inputed to all processes
+    MPI_Bcast(&N, 1, MPI_LONG_LONG, 0, MPI_COMM_WORLD);
+    if (N < 1){
+        if (myrank == 0)
+            printf("N must be positive\n");
+        MPI_Finalize();
+        return 1;
+    }
+
+    //Split the work evenly across each process, with 64-bit indices throughout
+    long long npp = N / numProcessors; //npp = numbers to calculate per process
+    long long nppr = N % numProcessors; //nppr = num per process remainder
+
+    long long sp = myrank * npp; // Start point
+    long long ep = sp + npp; // End point = start point + npp
+
+    //Add any remainders to the last process
+    if (myrank == numProcessors - 1)
+        ep += nppr;
+
+    //Each process's threads share its range
+    localSum = piKernelSumParallel(sp, ep, N, numThreads);
+
+    //Reduce to sum all the values of localSum into globalSum
+    MPI_Reduce(&localSum, &globalSum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    if (myrank == 0){
+        //Calculate the final value of pi
+        piVal = globalSum / (double)N;
+
+        // Get the clock current time again
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        time_taken = elapsedSeconds(start, end);
+
+        //Print output values, time taken and throughput
+        printf("Calculated Pi value (Hybrid-AlgoI) = %12.9f from rank %d \n", piVal, myrank);
+        printf("Error: %e\n", piVal - M_PI);
+        printf("Overall time (p) using %d processors x %d threads: %lf\n", numProcessors, numThreads, time_taken); // tp
+        printf("Throughput: %f GFLOP/s\n", (double)PI_FLOPS_PER_TERM * (double)N / time_taken * 1e-9);
+    }
+    //Exit
+    MPI_Finalize();
+    return 0;
+}
+
+double elapsedSeconds(struct timespec start, struct timespec end){
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+}
+
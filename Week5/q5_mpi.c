@@ -4,7 +4,7 @@
 #include <time.h>
 #include <mpi.h>
 int main(int argc, char* argv[]){
-    int i;
+    long i;
     double localSum= 0.0;
     double globalSum = 0.0;
     double piVal;
@@ -34,11 +34,11 @@ int main(int argc, char* argv[]){
   
     
     //Split the work evenly across each process
-    int npp= N/numProcessors; //npp = numbers to calculate per process
-    int nppr = N % numProcessors; //nppr = num per process remainder
+    long npp= N/numProcessors; //npp = numbers to calculate per process
+    long nppr = N % numProcessors; //nppr = num per process remainder
     
-    int sp = myrank * npp; // Start point
-	int ep = sp + npp; // End point = start point + npp
+    long sp = myrank * npp; // Start point
+	long ep = sp + npp; // End point = start point + npp
 	
 	//Add any remainders to the last thread
 	if(myrank == numProcessors-1)
@@ -3,12 +3,22 @@
 #include <math.h>
 #include <time.h>
 static long N = 100000000;
+// usage: q5_serial [N]   (N defaults to 100000000)
+// build: gcc q5_serial.c -lm
 int main(int argc, char* argv[]){
-    int i;
+    long i;
     double sum = 0.0;
     double piVal;
     struct timespec start, end;
     double time_taken;
+
+    //N may be given on the command line so runs can be scripted
+    if (argc > 1)
+        N = atol(argv[1]);
+    if (N < 1){
+        printf("usage: %s [N]\n", argv[0]);
+        return 1;
+    }
     
     // Get current clock time.
     clock_gettime(CLOCK_MONOTONIC, &start);
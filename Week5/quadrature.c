@@ -0,0 +1,391 @@
+/*
+ * Distributed adaptive Gauss-Kronrod (G7-K15) quadrature with work stealing.
+ *
+ * Stealing uses point-to-point messages: a process with an empty heap sends a
+ * request to the next process in turn, and that process replies with up to
+ * QUAD_MAX_STEAL of its worst subintervals (possibly none). Processes add to
+ * a reduction at different times, so one round can count a subinterval on both
+ * sides of a steal while missing another in flight, and still see equal sent and
+ * received totals. A round's totals are only trusted when it and the round
+ * before both saw the same sent and received totals, with the two equal: then no
+ * process sent or received anything in between, and nothing was in flight.
+ */
+#include "quadrature.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+//Bisections between looks at the message queue
+#define QUAD_BATCH 8
+//Subintervals handed over per steal; four doubles each
+#define QUAD_MAX_STEAL 128
+#define TAG_STEAL_REQUEST 1
+#define TAG_STEAL_REPLY 2
+//Integrand calls per Gauss-Kronrod rule
+#define GK_POINTS 15
+
+typedef struct {
+    double a, b, value, error;
+} quadInterval;
+
+//Max-heap of the unfinished subintervals by error
+typedef struct {
+    quadInterval *items;
+    long long size, capacity;
+} intervalHeap;
+
+typedef struct {
+    MPI_Comm comm;
+    int rank, size;
+    const quadProblem *p;
+    double tol, length;
+    intervalHeap heap;
+    double heapError;                   //Sum of the errors in the heap
+    double doneValue, doneError;        //Sums over the finished subintervals
+    long long doneCount;
+    long long evaluations, sent, received;
+    //Thief side: at most one request out at a time
+    int requestOutstanding, victim, requestToken;
+    MPI_Request requestSend;
+    //Victim side: one reply buffer per possible thief
+    double *replyBuf;
+    MPI_Request *replySend;
+} quadState;
+
+//Kronrod nodes on [-1, 1] (the positive half, centre last) and weights
+static const double xgk[8] = {
+    0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+    0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+    0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+    0.207784955007898467600689403773245, 0.000000000000000000000000000000000
+};
+static const double wgk[8] = {
+    0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+    0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+    0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+    0.204432940075298892414161999234649, 0.209482141084727828012999174891714
+};
+//Gauss weights for xgk[1], xgk[3], xgk[5] and the centre
+static const double wg[4] = {
+    0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+    0.381830050505118944950369775488975, 0.417959183673469387755102040816327
+};
+
+static quadProblem problems[QUAD_MAX_INTEGRANDS];
+static int numProblems = 0;
+
+//Function Declarations
+static int gaussKronrod(quadIntegrand f, double a, double b, quadInterval *out);
+static void heapPush(intervalHeap *h, quadInterval iv);
+static quadInterval heapPop(intervalHeap *h);
+static void place(quadState *s, quadInterval iv, int finished);
+static void bisectWorst(quadState *s);
+static void answerRequests(quadState *s, int stopping);
+static void pollReply(quadState *s);
+static void sendRequest(quadState *s);
+
+int quadRegister(const char *name, quadIntegrand f, double a, double b, double exact)
+{
+    if (numProblems == QUAD_MAX_INTEGRANDS)
+        return -1;
+    problems[numProblems].name = name;
+    problems[numProblems].f = f;
+    problems[numProblems].a = a;
+    problems[numProblems].b = b;
+    problems[numProblems].exact = exact;
+    numProblems++;
+    return 0;
+}
+
+const quadProblem *quadFind(const char *name)
+{
+    for (int i = 0; i < numProblems; i++) {
+        if (strcmp(problems[i].name, name) == 0)
+            return &problems[i];
+    }
+    return NULL;
+}
+
+int quadCount(void)
+{
+    return numProblems;
+}
+
+const quadProblem *quadGet(int i)
+{
+    return (i >= 0 && i < numProblems) ? &problems[i] : NULL;
+}
+
+//15-point Kronrod estimate of the integral over [a, b], with its difference from the
+//embedded 7-point Gauss rule scaled into an error estimate the way QUADPACK's qk15 does.
+//Returns 1 if the error is down at the rounding floor and bisecting cannot lower it.
+static int gaussKronrod(quadIntegrand f, double a, double b, quadInterval *out)
+{
+    double centre = 0.5 * (a + b), half = 0.5 * (b - a);
+    double fc = f(centre);
+    double resg = fc * wg[3], resk = fc * wgk[7];
+    double resabs = fabs(resk);
+    double fv1[7], fv2[7];
+    for (int j = 0; j < 7; j++) {
+        double dx = half * xgk[j];
+        double f1 = f(centre - dx), f2 = f(centre + dx);
+        fv1[j] = f1;
+        fv2[j] = f2;
+        resk += wgk[j] * (f1 + f2);
+        resabs += wgk[j] * (fabs(f1) + fabs(f2));
+        if (j % 2 == 1)
+            resg += wg[j / 2] * (f1 + f2);
+    }
+    double mean = 0.5 * resk;
+    double resasc = wgk[7] * fabs(fc - mean);
+    for (int j = 0; j < 7; j++)
+        resasc += wgk[j] * (fabs(fv1[j] - mean) + fabs(fv2[j] - mean));
+
+    half = fabs(half);
+    resabs *= half;
+    resasc *= half;
+    double err = fabs((resk - resg) * half);
+    if (resasc != 0 && err != 0)
+        err = resasc * fmin(1.0, pow(200 * err / resasc, 1.5));
+    int limited = 0;
+    if (resabs > DBL_MIN / (50 * DBL_EPSILON) && err <= 50 * DBL_EPSILON * resabs) {
+        err = 50 * DBL_EPSILON * resabs;
+        limited = 1;
+    }
+    out->a = a;
+    out->b = b;
+    out->value = resk * (0.5 * (b - a));
+    out->error = err;
+    return limited;
+}
+
+static void heapPush(intervalHeap *h, quadInterval iv)
+{
+    if (h->size == h->capacity) {
+        h->capacity = h->capacity ? h->capacity * 2 : 64;
+        h->items = (quadInterval*)realloc(h->items, h->capacity * sizeof(quadInterval));
+    }
+    long long i = h->size++;
+    while (i > 0 && h->items[(i - 1) / 2].error < iv.error) {
+        h->items[i] = h->items[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    h->items[i] = iv;
+}
+
+static quadInterval heapPop(intervalHeap *h)
+{
+    quadInterval top = h->items[0];
+    quadInterval last = h->items[--h->size];
+    long long i = 0;
+    for (;;) {
+        long long child = 2 * i + 1;
+        if (child >= h->size)
+            break;
+        if (child + 1 < h->size && h->items[child + 1].error > h->items[child].error)
+            child++;
+        if (h->items[child].error <= last.error)
+            break;
+        h->items[i] = h->items[child];
+        i = child;
+    }
+    if (h->size > 0)
+        h->items[i] = last;
+    return top;
+}
+
+//Keep iv for more bisection unless its error fits its share of the tolerance, it
+//cannot be improved, or it is too narrow to split
+static void place(quadState *s, quadInterval iv, int finished)
+{
+    double width = iv.b - iv.a;
+    if (finished || iv.error <= s->tol * width / s->length
+        || width <= 4 * DBL_EPSILON * fmax(fabs(iv.a), fabs(iv.b))) {
+        s->doneValue += iv.value;
+        s->doneError += iv.error;
+        s->doneCount++;
+    } else {
+        heapPush(&s->heap, iv);
+        s->heapError += iv.error;
+    }
+}
+
+static void bisectWorst(quadState *s)
+{
+    quadInterval worst = heapPop(&s->heap);
+    s->heapError -= worst.error;
+    double mid = 0.5 * (worst.a + worst.b);
+    quadInterval left, right;
+    int leftLimited = gaussKronrod(s->p->f, worst.a, mid, &left);
+    int rightLimited = gaussKronrod(s->p->f, mid, worst.b, &right);
+    s->evaluations += 2 * GK_POINTS;
+    place(s, left, leftLimited);
+    place(s, right, rightLimited);
+}
+
+//Hand half of the heap (none once stopping) to every process that has asked
+static void answerRequests(quadState *s, int stopping)
+{
+    int flag;
+    MPI_Status status;
+    for (;;) {
+        MPI_Iprobe(MPI_ANY_SOURCE, TAG_STEAL_REQUEST, s->comm, &flag, &status);
+        if (!flag)
+            break;
+        int thief = status.MPI_SOURCE, token;
+        MPI_Recv(&token, 1, MPI_INT, thief, TAG_STEAL_REQUEST, s->comm, MPI_STATUS_IGNORE);
+
+        //The thief has already received the last reply, or it would not ask again
+        MPI_Wait(&s->replySend[thief], MPI_STATUS_IGNORE);
+        double *buf = s->replyBuf + (size_t)thief * 4 * QUAD_MAX_STEAL;
+        long long count = stopping ? 0 : s->heap.size / 2;
+        if (count > QUAD_MAX_STEAL)
+            count = QUAD_MAX_STEAL;
+        for (long long i = 0; i < count; i++) {
+            quadInterval iv = heapPop(&s->heap);
+            s->heapError -= iv.error;
+            buf[4 * i] = iv.a;
+            buf[4 * i + 1] = iv.b;
+            buf[4 * i + 2] = iv.value;
+            buf[4 * i + 3] = iv.error;
+        }
+        s->sent += count;
+        MPI_Isend(buf, (int)(4 * count), MPI_DOUBLE, thief, TAG_STEAL_REPLY, s->comm, &s->replySend[thief]);
+    }
+}
+
+//Take in the reply to our request if it has arrived
+static void pollReply(quadState *s)
+{
+    if (!s->requestOutstanding)
+        return;
+    int flag, count;
+    MPI_Status status;
+    MPI_Iprobe(s->victim, TAG_STEAL_REPLY, s->comm, &flag, &status);
+    if (!flag)
+        return;
+    double buf[4 * QUAD_MAX_STEAL];
+    MPI_Get_count(&status, MPI_DOUBLE, &count);
+    MPI_Recv(buf, count, MPI_DOUBLE, s->victim, TAG_STEAL_REPLY, s->comm, MPI_STATUS_IGNORE);
+    MPI_Wait(&s->requestSend, MPI_STATUS_IGNORE);
+    for (int i = 0; i < count / 4; i++) {
+        quadInterval iv = {buf[4 * i], buf[4 * i + 1], buf[4 * i + 2], buf[4 * i + 3]};
+        heapPush(&s->heap, iv);
+        s->heapError += iv.error;
+    }
+    s->received += count / 4;
+    s->requestOutstanding = 0;
+}
+
+//Out of work: ask the next process in turn
+static void sendRequest(quadState *s)
+{
+    if (s->size == 1 || s->requestOutstanding || s->heap.size > 0)
+        return;
+    s->victim = (s->victim + 1) % s->size;
+    if (s->victim == s->rank)
+        s->victim = (s->victim + 1) % s->size;
+    MPI_Isend(&s->requestToken, 1, MPI_INT, s->victim, TAG_STEAL_REQUEST, s->comm, &s->requestSend);
+    s->requestOutstanding = 1;
+}
+
+void quadIntegrate(MPI_Comm comm, const quadProblem *p, double tol, long long maxEvaluations, quadResult *result)
+{
+    quadState s;
+    memset(&s, 0, sizeof(quadState));
+    s.comm = comm;
+    MPI_Comm_rank(comm, &s.rank);
+    MPI_Comm_size(comm, &s.size);
+    s.p = p;
+    s.tol = tol;
+    s.length = p->b - p->a;
+    s.victim = s.rank;
+    s.replyBuf = (double*)malloc((size_t)s.size * 4 * QUAD_MAX_STEAL * sizeof(double));
+    s.replySend = (MPI_Request*)malloc(s.size * sizeof(MPI_Request));
+    for (int i = 0; i < s.size; i++)
+        s.replySend[i] = MPI_REQUEST_NULL;
+
+    //Start with one equal piece per process
+    quadInterval first;
+    double lo = p->a + s.length * s.rank / s.size;
+    double hi = s.rank == s.size - 1 ? p->b : p->a + s.length * (s.rank + 1) / s.size;
+    int limited = gaussKronrod(p->f, lo, hi, &first);
+    s.evaluations = GK_POINTS;
+    place(&s, first, limited);
+
+    //Totals reduced each round: error, evaluations, unfinished subintervals, sent, received
+    double local[5], global[5];
+    MPI_Request reduceRequest;
+    int reducing = 0, stop = 0;
+    long long rounds = 0;
+    double lastSent = -1, lastReceived = -1;
+    while (!stop) {
+        for (int i = 0; i < QUAD_BATCH && s.heap.size > 0; i++)
+            bisectWorst(&s);
+        answerRequests(&s, 0);
+        pollReply(&s);
+        sendRequest(&s);
+
+        if (!reducing) {
+            local[0] = s.doneError + s.heapError;
+            local[1] = (double)s.evaluations;
+            local[2] = (double)s.heap.size;
+            local[3] = (double)s.sent;
+            local[4] = (double)s.received;
+            MPI_Iallreduce(local, global, 5, MPI_DOUBLE, MPI_SUM, comm, &reduceRequest);
+            reducing = 1;
+        } else {
+            int done;
+            MPI_Test(&reduceRequest, &done, MPI_STATUS_IGNORE);
+            if (done) {
+                //Every process sees the same totals, so they all stop in the same round
+                reducing = 0;
+                rounds++;
+                int settled = global[3] == global[4] && global[3] == lastSent && global[4] == lastReceived;
+                lastSent = global[3];
+                lastReceived = global[4];
+                if ((settled && (global[0] <= tol || global[2] == 0)) || global[1] >= (double)maxEvaluations)
+                    stop = 1;
+            }
+        }
+    }
+
+    //Finish any steal still in flight. Once everyone has passed the barrier, every
+    //request has been answered, so no more can arrive.
+    while (s.requestOutstanding) {
+        answerRequests(&s, 1);
+        pollReply(&s);
+    }
+    MPI_Request barrier;
+    int passed = 0;
+    MPI_Ibarrier(comm, &barrier);
+    while (!passed) {
+        answerRequests(&s, 1);
+        MPI_Test(&barrier, &passed, MPI_STATUS_IGNORE);
+    }
+    MPI_Waitall(s.size, s.replySend, MPI_STATUSES_IGNORE);
+
+    //The result is every finished and unfinished subinterval on every process
+    double totals[5];
+    local[0] = s.doneValue;
+    local[1] = s.doneError;
+    for (long long i = 0; i < s.heap.size; i++) {
+        local[0] += s.heap.items[i].value;
+        local[1] += s.heap.items[i].error;
+    }
+    local[2] = (double)s.evaluations;
+    local[3] = (double)(s.doneCount + s.heap.size);
+    local[4] = (double)s.sent;
+    MPI_Allreduce(local, totals, 5, MPI_DOUBLE, MPI_SUM, comm);
+    result->value = totals[0];
+    result->error = totals[1];
+    result->evaluations = (long long)totals[2];
+    result->intervals = (long long)totals[3];
+    result->steals = (long long)totals[4];
+    result->rounds = rounds;
+
+    free(s.heap.items);
+    free(s.replyBuf);
+    free(s.replySend);
+}
@@ -0,0 +1,48 @@
+/*
+ * Adaptive Gauss-Kronrod quadrature spread over MPI processes.
+ *
+ * [a, b] starts out cut into one piece per process. Every process keeps its
+ * subintervals in a heap ordered by error estimate and keeps bisecting the worst
+ * one with a 15-point Gauss-Kronrod rule. A subinterval is finished once its
+ * error fits its share of the tolerance, which is in proportion to its length.
+ * A process that runs out of work asks another process for half of its heap.
+ * Meanwhile the processes keep a non-blocking MPI_Iallreduce of the total
+ * integral and error going, and stop as soon as the error meets the tolerance.
+ */
+#ifndef QUADRATURE_H
+#define QUADRATURE_H
+
+#include <mpi.h>
+
+#define QUAD_MAX_INTEGRANDS 32
+
+typedef double (*quadIntegrand)(double x);
+
+typedef struct {
+    const char *name;
+    quadIntegrand f;
+    double a, b;
+    double exact;           //NAN when unknown
+} quadProblem;
+
+typedef struct {
+    double value, error;    //Integral and its estimated error
+    long long evaluations;  //Integrand calls over all processes
+    long long intervals;    //Subintervals the result is made of
+    long long steals;       //Subintervals moved between processes
+    long long rounds;       //Completed MPI_Iallreduce rounds
+} quadResult;
+
+//Add an integrand under name. Returns 0 on success, -1 if the table is full
+int quadRegister(const char *name, quadIntegrand f, double a, double b, double exact);
+//The integrand registered under name, or NULL
+const quadProblem *quadFind(const char *name);
+//Registered integrands in the order they were added
+int quadCount(void);
+const quadProblem *quadGet(int i);
+
+//Integrate p->f over [p->a, p->b] to within tol, or until maxEvaluations calls have
+//been made. Collective over comm; every process gets the same result.
+void quadIntegrate(MPI_Comm comm, const quadProblem *p, double tol, long long maxEvaluations, quadResult *result);
+
+#endif
@@ -0,0 +1,62 @@
+/*
+ * Collective prime list output: byte counts, MPI_Exscan offsets, MPI_File_write_at_all.
+ */
+#include "primes_mpiio.h"
+#include <stdlib.h>
+#include <string.h>
+#include "../Week3/primes_writer.h"
+
+//Each process formats into a buffer of this size, so one collective write moves at
+//most this much per process and counts always fit in an int
+#define MPIIO_BUFFER_BYTES (4 << 20)
+
+int primeSetWriteMPI(MPI_Comm comm, const char *filename, const char *header, const primeSet *s)
+{
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    size_t headerLen = (rank == 0 && header != NULL) ? strlen(header) : 0;
+
+    //This process's text starts after the text of every lower rank
+    uint64_t myBytes = headerLen + primeSetTextLength(s, 0, s->numWords);
+    uint64_t offset = 0;
+    MPI_Exscan(&myBytes, &offset, 1, MPI_UINT64_T, MPI_SUM, comm);
+    if (rank == 0)
+        offset = 0;
+
+    MPI_File fh;
+    int failed = MPI_File_open(comm, filename, MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS;
+    int anyFailed;
+    MPI_Allreduce(&failed, &anyFailed, 1, MPI_INT, MPI_LOR, comm);
+    if (anyFailed) {
+        if (!failed)
+            MPI_File_close(&fh);
+        return -1;
+    }
+    //Drop anything an older, longer file left behind
+    MPI_File_set_size(fh, 0);
+
+    //Every process must join every collective write, so all of them run as many rounds
+    //as the process with the most text; the rest write nothing in the rounds they don't need
+    uint64_t myRounds = (myBytes + MPIIO_BUFFER_BYTES - 64 * WRITER_MAX_LINE - 1) / (MPIIO_BUFFER_BYTES - 64 * WRITER_MAX_LINE);
+    uint64_t rounds;
+    MPI_Allreduce(&myRounds, &rounds, 1, MPI_UINT64_T, MPI_MAX, comm);
+
+    char *buf = (char*)malloc(MPIIO_BUFFER_BYTES + headerLen);
+    uint64_t w = 0;
+    for (uint64_t round = 0; round < rounds; round++) {
+        size_t len = 0;
+        if (round == 0 && headerLen > 0) {
+            memcpy(buf, header, headerLen);
+            len = headerLen;
+        }
+        len += primeSetFormatWords(buf + len, MPIIO_BUFFER_BYTES, s, &w, s->numWords);
+        if (MPI_File_write_at_all(fh, (MPI_Offset)offset, buf, (int)len, MPI_CHAR, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+            failed = 1;
+        offset += len;
+    }
+    free(buf);
+
+    MPI_File_close(&fh);
+    MPI_Allreduce(&failed, &anyFailed, 1, MPI_INT, MPI_LOR, comm);
+    return anyFailed ? -1 : 0;
+}
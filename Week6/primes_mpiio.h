@@ -0,0 +1,20 @@
+/*
+ * One ordered prime list file written by every process at once with MPI-IO.
+ *
+ * Each process holds the primes of its own slice of the numbers, in increasing
+ * rank order. It counts the bytes its primes format to and takes MPI_Exscan of
+ * the counts to find where its text starts in the file. All processes then
+ * write together with MPI_File_write_at_all, so nothing is gathered to the root.
+ */
+#ifndef PRIMES_MPIIO_H
+#define PRIMES_MPIIO_H
+
+#include <mpi.h>
+#include "../Week3/primes_bitset.h"
+
+//Write header (taken from the process of rank 0 only) followed by the members of
+//every process's s, one per line, to filename, replacing it. Collective over comm.
+//Returns 0 on success, -1 if any process failed to open or write.
+int primeSetWriteMPI(MPI_Comm comm, const char *filename, const char *header, const primeSet *s);
+
+#endif
@@ -3,20 +3,38 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <time.h>
+#include <string.h>
 #include <mpi.h> 
+#include "../Week3/primes_bitset.h"
+#include "../Week3/primes_writer.h"
+#include "../Week3/primes_primality.h"
+#include "primes_mpiio.h"
 
 //Function Declarrations
-bool isPrime(int n);
-void processFunc(int rank, int size, int number);
+void processFunc(int rank, int size, long long number, bool useMPIIO);
 
+// usage: mpirun -np P q2d [-o files|mpiio]
+// build: mpicc q2d.c primes_mpiio.c ../Week3/primes_bitset.c ../Week3/primes_primality.c ../Week3/primes_writer.c -lm -lpthread
 int main(int argc, char **argv){
     
-    int rank, size, n, r_value;
+    int rank, size;
+    long long n, r_value;
     MPI_Status status;
     MPI_Init(&argc, &argv);
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
 
+    // Pick the output: one file per process (default) or one file written collectively with MPI-IO
+    bool useMPIIO = false;
+    if (argc == 3 && strcmp(argv[1], "-o") == 0 && (strcmp(argv[2], "files") == 0 || strcmp(argv[2], "mpiio") == 0)){
+        useMPIIO = strcmp(argv[2], "mpiio") == 0;
+    } else if (argc != 1){
+        if (rank == 0)
+            printf("usage: %s [-o files|mpiio]\n", argv[0]);
+        MPI_Finalize();
+        return 1;
+    }
+
     // Initialise variables for timing program runtime
     clock_t start, end;
     double cpu_time_used;
@@ -25,22 +43,22 @@ int main(int argc, char **argv){
 	    // Read user input and store it in variable 'n'
         printf("Enter a number: ");
         fflush(stdout);
-        scanf("%d", &n);
+        scanf("%lld", &n);
         
         // Start timer
         start = clock();
         
-        MPI_Send(&n, 1, MPI_INT, rank + 1, 0, MPI_COMM_WORLD);
+        MPI_Send(&n, 1, MPI_LONG_LONG, rank + 1, 0, MPI_COMM_WORLD);
         
-	    processFunc(rank, size, n);
+	    processFunc(rank, size, n, useMPIIO);
 	} else {
 	    //Send and receieve n value to other processes
-        MPI_Recv(&r_value, 1, MPI_INT, rank - 1, 0, MPI_COMM_WORLD, &status);   
+        MPI_Recv(&r_value, 1, MPI_LONG_LONG, rank - 1, 0, MPI_COMM_WORLD, &status);   
 	    if(rank != size - 1){
-	        MPI_Send(&r_value, 1, MPI_INT, rank + 1, 0, MPI_COMM_WORLD);
+	        MPI_Send(&r_value, 1, MPI_LONG_LONG, rank + 1, 0, MPI_COMM_WORLD);
 	    } 
         
-        processFunc(rank, size, r_value);
+        processFunc(rank, size, r_value, useMPIIO);
 	}
     
     // End timer and print duration
@@ -53,67 +71,56 @@ int main(int argc, char **argv){
     return 0;
 }
 
-void processFunc(int rank, int size, int number){
+void processFunc(int rank, int size, long long number, bool useMPIIO){
     //Split the work across each thread
-    int npp= number/size; //npt = numbers per process
-    int nppr = number % size; //nrpt = num per process remainder
+    long long npp= number/size; //npt = numbers per process
+    long long nppr = number % size; //nrpt = num per process remainder
 
-    int sp = rank * npp; // Start point
-	int ep = sp + npp; // End point = start point + npp
+    long long sp = rank * npp; // Start point
+	long long ep = sp + npp; // End point = start point + npp
 
 	//Add remainders to the first thread
 	if(rank == size-1)
 		ep += nppr;
     
-    // Initialise array that will contain prime numbers found
-    int *array= NULL;
-    array = (int*)malloc(number * sizeof(int));
+    // Initialise bit set that will contain prime numbers found; it only needs this process's range
+    primeSet primes;
+    primeSetInit(&primes, sp, ep);
     
     // Shared memory parallelism
-    for(int i = sp; i< ep; i++){ 
-		if(isPrime(i)){
-            array[i] = i;
+    for(long long i = sp; i< ep; i++){
+		if(isPrime64(i)){
+            primeSetAdd(&primes, i);
         }
 	}
 	
+	if (useMPIIO){
+	    //Every process writes its own primes straight into place in one file
+	    char header[100];
+	    sprintf(header, "Prime Numbers from %d to %lld:\n", 0, number);
+	    int result = primeSetWriteMPI(MPI_COMM_WORLD, "primes_all.txt", header, &primes);
+	    if (rank == 0)
+	        printf(result == 0 ? "%s created\n" : "Could not write %s\n", "primes_all.txt");
+	    fflush(stdout);
+	    primeSetFree(&primes);
+	    return;
+	}
+	
 	//Create filename for each process
 	char filename[100];
 	sprintf(filename, "primes_%d.txt", rank);
 	
     FILE *fp;
     fp = fopen(filename, "w+");
-    fprintf(fp, "Prime Numbers from %d to %d:\n", sp, ep);
+    fprintf(fp, "Prime Numbers from %lld to %lld:\n", sp, ep);
     
     //Write prime numbers to file
-    for (int i = 0; i < number; i++){
-        if (array[i])
-            fprintf(fp, "%d\n", i);
-    }
+    primeSetWriteParallel(fp, &primes, 1);
     
     //Close file and free allocated memory
     fclose(fp);
     printf("%s created\n", filename);
     fflush(stdout);
-    free(array);
+    primeSetFree(&primes);
     return;
 }
-
-// Reference: https://www.geeksforgeeks.org/print-all-prime-numbers-less-than-or-equal-to-n/
-bool isPrime(int n){
-    // Edge cases
-    if (n <= 1)
-        return false;
-    if (n <= 3)
-        return true;
-
-    // An optimisation to reduce the number of iterations in the 'for' loop
-    if(n % 2 == 0 || n % 3 == 0)
-        return false;
-
-    for(int i = 5; i <= sqrt(n); i = i + 6){
-        if (n % i == 0 || n % (i + 2) == 0)
-            return false;
-    }
-
-    return true;
-}
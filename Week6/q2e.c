@@ -3,22 +3,54 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <time.h>
+#include <unistd.h>
+#include <string.h>
+#include <limits.h>
 #include <mpi.h> 
+#include "../Week3/primes_sieve.h"
+#include "../Week3/primes_bitset.h"
+#include "../Week3/primes_writer.h"
+#include "../Week3/primes_primality.h"
+#include "primes_mpiio.h"
+
+//Gathering to the root counts and places words of the bit set with ints
+#define GATHER_MAX_LIMIT ((long long)INT_MAX * PRIME_SET_WORD_SPAN)
 
 //Function Declarrations
-bool isPrime(int n);
 
+// usage: mpirun -np P q2e [-m sieve|trial] [-o gather|mpiio]
+// build: mpicc q2e.c primes_mpiio.c ../Week3/primes_sieve.c ../Week3/primes_bitset.c ../Week3/primes_primality.c ../Week3/primes_writer.c -lm -lpthread
 int main(int argc, char **argv){
     
-    int rank, size, n, r_value;
-    MPI_Status status;
+    int rank, size;
+    long long n;
     MPI_Init(&argc, &argv);
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // Pick the method: distributed segmented sieve (default) or testing each number,
+    // and the output: gather everything to the root (default) or write collectively with MPI-IO
+    bool useSieve = true;
+    bool useMPIIO = false;
+    bool badArgs = argc % 2 == 0;
+    for (int i = 1; i + 1 < argc; i += 2){
+        if (strcmp(argv[i], "-m") == 0 && (strcmp(argv[i + 1], "sieve") == 0 || strcmp(argv[i + 1], "trial") == 0))
+            useSieve = strcmp(argv[i + 1], "sieve") == 0;
+        else if (strcmp(argv[i], "-o") == 0 && (strcmp(argv[i + 1], "gather") == 0 || strcmp(argv[i + 1], "mpiio") == 0))
+            useMPIIO = strcmp(argv[i + 1], "mpiio") == 0;
+        else
+            badArgs = true;
+    }
+    if (badArgs){
+        if (rank == 0)
+            printf("usage: %s [-m sieve|trial] [-o gather|mpiio]\n", argv[0]);
+        MPI_Finalize();
+        return 1;
+    }
    
     
-    // Initialise array that will contain prime numbers found
-    int *primesArray= NULL;
+    // Initialise bit set that will contain prime numbers found
+    primeSet primes;
 
     // Initialise variables for timing program runtime
     clock_t start, end;
@@ -28,7 +60,15 @@ int main(int argc, char **argv){
 	    // Read user input and store it in variable 'n'
         printf("Enter a number: ");
         fflush(stdout);
-        scanf(" %d", &n);
+        scanf(" %lld", &n);
+        if (useSieve && n > (long long)SIEVE_MAX_LIMIT){
+            printf("n is too large for the sieve\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        if (!useMPIIO && n > GATHER_MAX_LIMIT){
+            printf("n is too large to gather to the root process (at most %lld), use -o mpiio\n", GATHER_MAX_LIMIT);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
           
         // Start timer
         start = clock();
@@ -37,15 +77,18 @@ int main(int argc, char **argv){
 	}
 	
 	//Broadcast the value of n to all processes
-    MPI_Bcast(&n,1,MPI_INT,0,MPI_COMM_WORLD);
+    MPI_Bcast(&n,1,MPI_LONG_LONG,0,MPI_COMM_WORLD);
+    if (n < 0)
+        n = 0;
     
     
-    //Split the work across each process 
-    int npp= n/size; //npt = numbers per process
-    int nppr = n % size; //nrpt = num per process remainder
+    //Split the work across each process in whole words of the bit set, so every
+    //process's words can be gathered straight into place in the root's set
+    long long npp= n / size / PRIME_SET_WORD_SPAN * PRIME_SET_WORD_SPAN; //npt = numbers per process
+    long long nppr = n - npp * size; //nrpt = num per process remainder
 
-    int sp = rank * npp; // Start point
-	int ep = sp + npp; // End point = start point + npp
+    long long sp = rank * npp; // Start point
+	long long ep = sp + npp; // End point = start point + npp
 
 	//Add remainders to the last process
 	if(rank == size-1)
@@ -55,65 +98,111 @@ int main(int argc, char **argv){
     
 
     //Allocate memory
-    if (rank==0){
+    if (rank==0 && !useMPIIO){
         //Root process will need all results
-        primesArray=(int*)malloc(n * sizeof(int));
+        primeSetInit(&primes, 0, n);
     }
     else{
-        //Other processes only need memory for numbers they are calculating
-        primesArray = (int*)malloc((ep-sp) * sizeof(int));
+        //Other processes, and every process when writing with MPI-IO, only need
+        //memory for numbers they are calculating
+        primeSetInit(&primes, sp, ep);
     }
     
     
-    // Parallel computing of prime numbers
-    for(int i = sp; i< ep; i++){ 
-		if(isPrime(i)){
-            primesArray[i-sp] = i;
+    if (useSieve){
+        //Root process finds the sieving primes up to sqrt(n) and broadcasts them
+        primeSieve sieve;
+        uint64_t numBase = 0;
+        if (rank == 0){
+            sieveInit(&sieve, n);
+            numBase = sieve.numPrimes;
         }
-	}
-    
-    //Send the arrays results back to the root process
-    if (rank==0){
-        //Root process only needse to receive data
-        int offset;
-        offset = npp;
-        for (int i=1; i< size; i++){
-        
-            //Iterate through each process and receive their data sent
-            if (i!=size-1){
-		        MPI_Recv((int*)primesArray + offset, npp, MPI_INT, i, 0, MPI_COMM_WORLD, &status);
-            }
-            else{
-                //Last process will send any remainders so need to change input size
-		        MPI_Recv((int*)primesArray + offset, npp+nppr, MPI_INT, i, 0, MPI_COMM_WORLD, &status);
+        MPI_Bcast(&numBase, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+        uint32_t *basePrimes = rank == 0 ? sieve.primes : (uint32_t*)malloc((numBase > 0 ? numBase : 1) * sizeof(uint32_t));
+        MPI_Bcast(basePrimes, (int)numBase, MPI_UINT32_T, 0, MPI_COMM_WORLD);
+        if (rank != 0){
+            sieveInitWithPrimes(&sieve, n, basePrimes, numBase);
+            free(basePrimes);
+        }
+
+        //Sieve this process's numbers one cache-sized segment at a time into its bit set
+        uint8_t *flags = (uint8_t*)malloc(SIEVE_SEGMENT_BYTES);
+        uint64_t *found = (uint64_t*)malloc(SIEVE_SEGMENT_BYTES * sizeof(uint64_t));
+        for (long long lo = sp; lo < ep; lo += SIEVE_SEGMENT_SPAN){
+            long long hi = ep - lo < (long long)SIEVE_SEGMENT_SPAN ? ep : lo + (long long)SIEVE_SEGMENT_SPAN;
+            size_t count = sieveRange(&sieve, lo, hi, flags, found);
+            for (size_t i = 0; i < count; i++)
+                primeSetAdd(&primes, found[i]);
+        }
+        free(flags);
+        free(found);
+        sieveFree(&sieve);
+    } else {
+        // Parallel computing of prime numbers
+        for(long long i = sp; i< ep; i++){
+            if(isPrime64(i)){
+                primeSetAdd(&primes, i);
             }
-            //Increase offset pointer by amount of numbers per process
-		    offset += npp; 
-        } 
-  
+        }
     }
-    else{
-        //Send data to root process
-        fflush(stdout);
-        MPI_Send((int*)primesArray, (ep - sp), MPI_INT, 0, 0, MPI_COMM_WORLD);
+    uint64_t myCount = primeSetCount(&primes);
 
+    //Gather the prime counts to the root process, and unless writing with MPI-IO the bit sets
+    //too. Process i's words go to word i * npp / PRIME_SET_WORD_SPAN of the root's set; the
+    //root's own are already there.
+    int *wordCounts = NULL, *wordDispls = NULL;
+    uint64_t *primeCounts = NULL;
+    if (rank==0){
+        wordCounts = (int*)malloc(size * sizeof(int));
+        wordDispls = (int*)malloc(size * sizeof(int));
+        primeCounts = (uint64_t*)malloc(size * sizeof(uint64_t));
+        for (int i=0; i< size; i++){
+            long long isp = i * npp;
+            long long iep = (i == size - 1) ? n : isp + npp;
+            wordCounts[i] = (int)(((iep - isp) / 2 + 63) / 64);
+            wordDispls[i] = (int)(isp / PRIME_SET_WORD_SPAN);
+        }
     }
-    
+    if (!useMPIIO)
+        MPI_Gatherv(rank == 0 ? MPI_IN_PLACE : primes.words, (int)primes.numWords, MPI_UINT64_T,
+                    primes.words, wordCounts, wordDispls, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+    MPI_Gather(&myCount, 1, MPI_UINT64_T, primeCounts, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+
+    if (rank == 0){
+        uint64_t total = 0;
+        for (int i=0; i< size; i++){
+            printf("Process %d found %llu primes\n", i, (unsigned long long)primeCounts[i]);
+            total += primeCounts[i];
+        }
+        printf("%llu primes less than %lld\n", (unsigned long long)total, n);
+        free(wordCounts);
+        free(wordDispls);
+        free(primeCounts);
+    }
+
+    if (useMPIIO){
+        //Every process writes its own primes straight into place in one file
+        char header[100];
+        sprintf(header, "Prime Numbers from %d to %lld:\n", 0, n);
+        int result = primeSetWriteMPI(MPI_COMM_WORLD, "primes_all.txt", header, &primes);
+        if (rank == 0)
+            printf(result == 0 ? "%s created\n" : "Could not write %s\n", "primes_all.txt");
+    }
+
     if (rank ==0){
-        //Write prime numbers to file
-        FILE *fp;
-        fp = fopen("primes_all.txt", "w+");
-        fprintf(fp, "Prime Numbers from %d to %d:\n", 0, n);
-
-       
-        for (int i = 0; i < n; i++){
-            if (primesArray[i])
-                fprintf(fp, "%d\n", i);
+        if (!useMPIIO){
+            //Write prime numbers to file
+            FILE *fp;
+            fp = fopen("primes_all.txt", "w+");
+            fprintf(fp, "Prime Numbers from %d to %lld:\n", 0, n);
+
+            //Format and write with one thread per core
+            primeSetWriteParallel(fp, &primes, (int)sysconf(_SC_NPROCESSORS_ONLN));
+
+            //Close file and free allocated memory
+            fclose(fp);
+            printf("%s created\n", "primes_all.txt");
         }
-        
-        //Close file and free allocated memory
-        fclose(fp);
-        printf("%s created\n", "primes_all.txt");
         fflush(stdout);
         
         
@@ -125,29 +214,7 @@ int main(int argc, char **argv){
     }
     
     //Cleanup and Exit program 
-    free(primesArray);
+    primeSetFree(&primes);
     MPI_Finalize();
     return 0;
 }
-
-  
-
-// Reference: https://www.geeksforgeeks.org/print-all-prime-numbers-less-than-or-equal-to-n/
-bool isPrime(int n){
-    // Edge cases
-    if (n <= 1)
-        return false;
-    if (n <= 3)
-        return true;
-
-    // An optimisation to reduce the number of iterations in the 'for' loop
-    if(n % 2 == 0 || n % 3 == 0)
-        return false;
-
-    for(int i = 5; i <= sqrt(n); i = i + 6){
-        if (n % i == 0 || n % (i + 2) == 0)
-            return false;
-    }
-
-    return true;
-}
@@ -12,13 +12,14 @@
 #include <stdbool.h>
 #include <mpi.h>
 #include <time.h>
+#include "../Week3/primes_primality.h"
 #define SHIFT_ROW 0
 #define SHIFT_COL 1
 #define DISP 1
 
 int generatePrime();
-bool isPrime(int n);
 
+// build: mpicc q2.c ../Week3/primes_primality.c -lm
 int main(int argc, char *argv[]) {
     int ndims=2, size, my_rank, reorder, my_cart_rank, ierr;
     int nrows, ncols;
@@ -147,31 +148,10 @@ int generatePrime(int rank){
     
     while(!randomPrimeFound){
         randomNumber = rand() % (101); //Generate random number from 0-100
-        if(isPrime(randomNumber)){
+        if(isPrime64(randomNumber)){
             randomPrimeFound = true; 
         }
     }
     
     return randomNumber;
 }
-
-/* Code taken from Week 3 Lab */
-/* Reference: https://www.geeksforgeeks.org/print-all-prime-numbers-less-than-or-equal-to-n */
-bool isPrime(int n){
-    // Edge cases
-    if (n <= 1)
-        return false;
-    if (n <= 3)
-        return true;
-
-    // An optimisation to reduce the number of iterations in the 'for' loop
-    if(n % 2 == 0 || n % 3 == 0)
-        return false;
-
-    for(int i = 5; i <= sqrt(n); i = i + 6){
-        if (n % i == 0 || n % (i + 2) == 0)
-            return false;
-    }
-
-    return true;
-}